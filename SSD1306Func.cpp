@@ -22,588 +22,3852 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 
+#if SSD1306FUNC_SLEEP && defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
+#if SSD1306FUNC_DUAL_CORE
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#endif
+
 #define ON 1
 #define OFF 0
 #define RECOMM -1
 
+// Top of the dialog area, below the header label: the first two pages of GDDRAM, the yellow band on two-color panels.
+#define DIALOG_TOP (SSD1306_GDDRAM_ROWS / 4)
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Largest I2C transaction the Wire library can buffer, matching the limit used by `Adafruit_SSD1306::display()`.
+#if defined(I2C_BUFFER_LENGTH)
+#define WIRE_MAX min(256, I2C_BUFFER_LENGTH)
+#elif defined(BUFFER_LENGTH)
+#define WIRE_MAX min(256, BUFFER_LENGTH)
+#elif defined(SERIAL_BUFFER_SIZE)
+#define WIRE_MAX min(255, SERIAL_BUFFER_SIZE - 1)
+#else
+#define WIRE_MAX 32
+#endif
 
-// FILL SCREEN FUNCTIONS - FOR DEBUG/SCREEN TEST
+// Approximate bus cost, in bytes, of opening a column/page address window: one command transaction, and the address and
+// control byte of a separate data transaction. Used when deciding whether to merge windows.
+#define WINDOW_COST 12
 
-/// @brief Fills the screen with three passes of interlacing lines. For checking OLED screen dead pixels.
-/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
-void fillScreenSlow(Adafruit_SSD1306* display) {
-  int16_t i;
+// Largest data chunk sent per `pumpFlush()` call: one I2C transaction.
+#define FLUSH_CHUNK (WIRE_MAX - 1)
 
-  display->clearDisplay();
 
-  for(i=0; i<display->height(); i+=2) {
-    display->drawFastHLine(0, i, display->width(), ON);
-    display->display(); 
-    delay(5);
-  }
-  for(i=0; i<display->width(); i+=2) {
-    display->drawFastVLine(i, 0, display->height(), ON);
-    display->display(); 
-    delay(5);
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// PARTIAL FLUSH FUNCTIONS
+
+// `Adafruit_SSD1306` keeps its bus handles protected. Naming them through a derived class gives plain member pointers,
+// so partial flushes can talk to the same bus as `display()` without the sketch needing a subclassed display object.
+struct SSD1306Members : public Adafruit_SSD1306 {
+  static TwoWire* Adafruit_SSD1306::* const wireMember;
+  static SPIClass* Adafruit_SSD1306::* const spiMember;
+  static uint8_t* Adafruit_SSD1306::* const bufferMember;
+  static int8_t Adafruit_SSD1306::* const i2caddrMember;
+  static int8_t Adafruit_SSD1306::* const dcPinMember;
+  static int8_t Adafruit_SSD1306::* const csPinMember;
+#if ARDUINO >= 157
+  static uint32_t Adafruit_SSD1306::* const wireClkMember;
+  static uint32_t Adafruit_SSD1306::* const restoreClkMember;
+#endif
+#if defined(SPI_HAS_TRANSACTION)
+  static SPISettings Adafruit_SSD1306::* const spiSettingsMember;
+#endif
+  static uint8_t Adafruit_GFX::* const textsizeXMember;
+  static uint8_t Adafruit_GFX::* const textsizeYMember;
+  static GFXfont* Adafruit_GFX::* const gfxFontMember;
+  static uint16_t Adafruit_GFX::* const textcolorMember;
+  static uint16_t Adafruit_GFX::* const textbgcolorMember;
+  static bool Adafruit_GFX::* const wrapMember;
+  static bool Adafruit_GFX::* const cp437Member;
+};
+
+TwoWire* Adafruit_SSD1306::* const SSD1306Members::wireMember = &SSD1306Members::wire;
+SPIClass* Adafruit_SSD1306::* const SSD1306Members::spiMember = &SSD1306Members::spi;
+uint8_t* Adafruit_SSD1306::* const SSD1306Members::bufferMember = &SSD1306Members::buffer;
+int8_t Adafruit_SSD1306::* const SSD1306Members::i2caddrMember = &SSD1306Members::i2caddr;
+int8_t Adafruit_SSD1306::* const SSD1306Members::dcPinMember = &SSD1306Members::dcPin;
+int8_t Adafruit_SSD1306::* const SSD1306Members::csPinMember = &SSD1306Members::csPin;
+#if ARDUINO >= 157
+uint32_t Adafruit_SSD1306::* const SSD1306Members::wireClkMember = &SSD1306Members::wireClk;
+uint32_t Adafruit_SSD1306::* const SSD1306Members::restoreClkMember = &SSD1306Members::restoreClk;
+#endif
+#if defined(SPI_HAS_TRANSACTION)
+SPISettings Adafruit_SSD1306::* const SSD1306Members::spiSettingsMember = &SSD1306Members::spiSettings;
+#endif
+uint8_t Adafruit_GFX::* const SSD1306Members::textsizeXMember = &SSD1306Members::textsize_x;
+uint8_t Adafruit_GFX::* const SSD1306Members::textsizeYMember = &SSD1306Members::textsize_y;
+GFXfont* Adafruit_GFX::* const SSD1306Members::gfxFontMember = &SSD1306Members::gfxFont;
+uint16_t Adafruit_GFX::* const SSD1306Members::textcolorMember = &SSD1306Members::textcolor;
+uint16_t Adafruit_GFX::* const SSD1306Members::textbgcolorMember = &SSD1306Members::textbgcolor;
+bool Adafruit_GFX::* const SSD1306Members::wrapMember = &SSD1306Members::wrap;
+bool Adafruit_GFX::* const SSD1306Members::cp437Member = &SSD1306Members::_cp437;
+
+// A column/page address window, inclusive on both ends.
+typedef struct FlushWindow {
+  uint8_t startcol, endcol;
+  uint8_t startpage, endpage;
+} FlushWindow;
+
+typedef struct DisplayState {
+  Adafruit_SSD1306* display;                  // The display owning this slot, or `NULL` if the slot is free.
+  uint8_t dirtyStart[SSD1306FUNC_MAX_PAGES];  // First dirty column of each page, or `0xFF` if the page is clean.
+  uint8_t dirtyEnd[SSD1306FUNC_MAX_PAGES];    // Last dirty column of each page, inclusive.
+#if SSD1306FUNC_ASYNC_FLUSH
+  uint8_t* front;                             // Copy of the windows being sent, allocated by the first `startFlush()`.
+  FlushWindow windows[SSD1306FUNC_MAX_PAGES]; // Windows of `front` still to send, from `windowIndex` on.
+  uint8_t windowCount, windowIndex;
+  uint8_t sendPage, sendCol;                  // Next byte of the current window to send.
+  bool windowOpen;                            // Whether the controller's address window is already set to the current window.
+#endif
+#if SSD1306FUNC_SCENE_PREFETCH
+  uint8_t* back;                              // Second framebuffer scenes draw ahead into, allocated by the first `prefetch()`.
+#endif
+#if SSD1306FUNC_STATS
+  unsigned long busBytes;                     // Command and data bytes sent so far, read by the effect statistics.
+#endif
+  DisplaySelect select;                       // Called before talking to the display, if set by `setDisplaySelect()`.
+  uint8_t channel;
+  const GlyphFont* glyphFont;                 // Font of the fast text path, if set by `setGlyphFont()`.
+} DisplayState;
+
+static DisplayState displayStates[SSD1306FUNC_MAX_DISPLAYS];
+
+static void clearDirty(DisplayState* state) {
+  memset(state->dirtyStart, 0xFF, SSD1306FUNC_MAX_PAGES);
+  memset(state->dirtyEnd, 0, SSD1306FUNC_MAX_PAGES);
+}
+
+static DisplayState* getDisplayState(Adafruit_SSD1306* display) {
+  DisplayState* freeslot = NULL;
+
+  for (uint8_t i = 0; i < SSD1306FUNC_MAX_DISPLAYS; i++) {
+    if (displayStates[i].display == display) return &displayStates[i];
+    if (!displayStates[i].display && !freeslot) freeslot = &displayStates[i];
   }
-  for(i=1; i<display->height(); i+=2) {
-    display->drawFastHLine(0, i, display->width(), ON);
-    display->display(); 
-    delay(5);
+
+  if (freeslot) {
+    freeslot->display = display;
+    freeslot->select = NULL;
+    freeslot->glyphFont = NULL;
+    clearDirty(freeslot);
   }
+  return freeslot;
 }
 
-/// @brief Fills the screen instantly. Used for checking OLED dead pixels.
-/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
-void fillScreenFast(Adafruit_SSD1306* display) {
-  display->fillRect(0, 0, display->width(), display->height(), ON);
-  display->display();
+// Size of the unrotated panel, which is what the framebuffer and page layout follow.
+// Compile-time constants when `SSD1306FUNC_WIDTH` and `SSD1306FUNC_HEIGHT` are set.
+static inline int16_t getPanelWidth(Adafruit_SSD1306* display) {
+#if SSD1306FUNC_WIDTH
+  return SSD1306FUNC_WIDTH;
+#else
+  return display->getRotation() & 1 ? display->height() : display->width();
+#endif
 }
 
+static inline int16_t getPanelHeight(Adafruit_SSD1306* display) {
+#if SSD1306FUNC_HEIGHT
+  return SSD1306FUNC_HEIGHT;
+#else
+  return display->getRotation() & 1 ? display->width() : display->height();
+#endif
+}
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-// FADE WHITEOUT/BLACKOUT FUNCTIONS
+// GDDRAM column that the panel's first column is wired to.
+static inline uint8_t getColumnOffset(Adafruit_SSD1306* display) {
+#if SSD1306FUNC_COLUMN_OFFSET >= 0
+  return SSD1306FUNC_COLUMN_OFFSET;
+#else
+  return getPanelWidth(display) == 64 ? (SSD1306_GDDRAM_COLUMNS - 64) / 2 : 0;
+#endif
+}
 
-/// @brief A checkerboard-style fade transition. Fades in three steps, to either full black or full white/on.
-/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
-/// @param delaytime Number of milliseconds taken per step. Using negative values will use the recommended value (`50`).
-/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
-void fadeGrid(Adafruit_SSD1306* display, long delaytime, uint16_t state) {
-  if (delaytime < 0) delaytime = 50;   // Recommended delay time
+static inline uint8_t getPageCount(Adafruit_SSD1306* display) {
+  uint8_t pages = (getPanelHeight(display) + 7) / 8;
+  return pages < SSD1306FUNC_MAX_PAGES ? pages : SSD1306FUNC_MAX_PAGES;
+}
 
-  for(int i=0; i<display->width(); i+=2) {
-    display->drawFastVLine(i, 0, display->height(), state);
-  }
-  display->display(); 
-  delay(delaytime);
+// Software SPI leaves no bus handle behind, so only the regular full flush can reach the display.
+static bool hasBus(Adafruit_SSD1306* display) {
+  return (display->*SSD1306Members::wireMember) || (display->*SSD1306Members::spiMember);
+}
 
-  for(int i=0; i<display->height(); i+=2) {
-    display->drawFastHLine(0, i, display->width(), state);
-  }
-  display->display(); 
-  delay(delaytime);
+// Adds to the display's bus byte count. Does nothing unless `SSD1306FUNC_STATS` is `1`.
+static inline void countBytes(Adafruit_SSD1306* display, unsigned long count) {
+#if SSD1306FUNC_STATS
+  DisplayState* state = getDisplayState(display);
+  if (state) state->busBytes += count;
+#endif
+}
 
-  for(int i=1; i<display->width(); i+=2) {
-    display->drawFastVLine(i, 0, display->height(), state);
-  }
-  display->display(); 
-  delay(delaytime);
+#if SSD1306FUNC_STATS
+static unsigned long getBusBytes(Adafruit_SSD1306* display) {
+  DisplayState* state = getDisplayState(display);
+  return state ? state->busBytes : 0;
+}
+#endif
 
-  if (!state) {
-    display->clearDisplay();
-    display->display();
-    delay(delaytime);
-  }
+// The bus a display is on, so effects on different buses can be told apart.
+static const void* getBus(Adafruit_SSD1306* display) {
+  if (display->*SSD1306Members::wireMember) return display->*SSD1306Members::wireMember;
+  return display->*SSD1306Members::spiMember;
 }
 
-/// @brief A diagonal version of the grid fade transition. Fades in two steps, to either full black or full white/on.
-/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
-/// @param delaytime Number of milliseconds taken per step. Using negative values will use the recommended value (`50`).
-/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
-void fadeCross(Adafruit_SSD1306* display, long delaytime, uint16_t state) {
-  if (delaytime < 0) delaytime = 50;
-  
-  for(int i=0; i<display->width()+display->height(); i+=2) {
-    display->drawLine(0, i, i, 0, state);
-  }
-  display->display(); 
-  delay(delaytime);
+static DisplaySelect selectedHook = NULL;   // The channel last selected, so displays behind one multiplexer only switch it when needed
+static uint8_t selectedChannel;
 
-  for(int i=1; i<display->width()+display->height(); i+=2) {
-    display->drawLine(0, i, i, 0, state);
-  }
-  display->display(); 
-  delay(delaytime);
+// Calls the display's select hook, if any, before the library talks to it.
+static void selectDisplay(Adafruit_SSD1306* display) {
+  DisplayState* state = getDisplayState(display);
+  if (!state || !state->select) return;
+  if (state->select == selectedHook && state->channel == selectedChannel) return;
 
-  if (!state) {
-    display->clearDisplay();
-    display->display();
-    delay(delaytime);
-  }
+  selectedHook = state->select;
+  selectedChannel = state->channel;
+  state->select(state->channel);
 }
 
-/// @brief A fade transition resembling vertical blinds. Fades to either full black or full white/on.
-/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
-/// @param cycles Number of steps for the fade. Using negative values will use the recommended value (`4`).
-/// @param wholedelaytime The duration of the entire fade transition. Using negative values will use the recommended value.
-/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
-void fadeVertical(Adafruit_SSD1306* display, int cycles, long wholedelaytime, uint16_t state) {
-  // Recommended values
-  if (cycles < 0) cycles = 4;
-  if (wholedelaytime < 0) wholedelaytime = 10 * cycles;
-  
-  for(int i=0; i<cycles; i++) {
-    for(int j=i; j<display->width(); j+=cycles) {
-      display->drawFastVLine(j, 0, display->height(), state);
+static void sendData(Adafruit_SSD1306* display, const uint8_t* data, uint16_t count) {
+  selectDisplay(display);
+  countBytes(display, count);
+
+  TwoWire* wire = display->*SSD1306Members::wireMember;
+  SPIClass* spi = display->*SSD1306Members::spiMember;
+
+  if (wire) {
+#if ARDUINO >= 157
+    wire->setClock(display->*SSD1306Members::wireClkMember);
+#endif
+    while (count) {
+      uint8_t chunk = count < WIRE_MAX - 1 ? count : WIRE_MAX - 1;
+      wire->beginTransmission(display->*SSD1306Members::i2caddrMember);
+      wire->write((uint8_t) 0x40);   // Co = 0, D/C# = 1: the rest of the transaction is GDDRAM data
+      wire->write(data, chunk);
+      wire->endTransmission();
+      data += chunk;
+      count -= chunk;
     }
-    display->display(); 
-    delay((long) wholedelaytime / cycles);
+#if ARDUINO >= 157
+    wire->setClock(display->*SSD1306Members::restoreClkMember);
+#endif
   }
 
-  if (!state) {
-    display->clearDisplay();
-    display->display();
-    delay(wholedelaytime / cycles);
+  else if (spi) {
+#if defined(SPI_HAS_TRANSACTION)
+    spi->beginTransaction(display->*SSD1306Members::spiSettingsMember);
+#endif
+    digitalWrite(display->*SSD1306Members::csPinMember, LOW);
+    digitalWrite(display->*SSD1306Members::dcPinMember, HIGH);
+    while (count--) spi->transfer(*data++);
+    digitalWrite(display->*SSD1306Members::csPinMember, HIGH);
+#if defined(SPI_HAS_TRANSACTION)
+    spi->endTransaction();
+#endif
   }
 }
 
-/// @brief A fade transition resembling horizontal blinds. Fades to either full black or full white/on.
-/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
-/// @param cycles Number of steps for the fade. Using negative values will use the recommended value (`3`).
-/// @param wholedelaytime The duration of the entire fade transition. Using negative values will use the recommended value.
-/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
-void fadeHorizontal(Adafruit_SSD1306* display, int cycles, long wholedelaytime, uint16_t state) {
-  // Recommended values
-  if (cycles < 0) cycles = 3;
-  if (wholedelaytime < 0) wholedelaytime = 10 * cycles;
-  
-  for(int i=0; i<cycles; i++) {
-    for(int j=i; j<display->height(); j+=cycles) {
-      display->drawFastHLine(0, j, display->width(), state);
+// Sends a command sequence in as few transactions as the bus buffer allows, where `ssd1306_command()` takes one I2C
+// transaction per byte. Software SPI has no bus handle, so it still goes a byte at a time.
+static void sendCommands(Adafruit_SSD1306* display, const uint8_t* commands, uint8_t count) {
+  selectDisplay(display);
+  countBytes(display, count);
+
+  TwoWire* wire = display->*SSD1306Members::wireMember;
+  SPIClass* spi = display->*SSD1306Members::spiMember;
+
+  if (wire) {
+#if ARDUINO >= 157
+    wire->setClock(display->*SSD1306Members::wireClkMember);
+#endif
+    while (count) {
+      uint8_t chunk = count < WIRE_MAX - 1 ? count : WIRE_MAX - 1;
+      wire->beginTransmission(display->*SSD1306Members::i2caddrMember);
+      wire->write((uint8_t) 0x00);   // Co = 0, D/C# = 0: the rest of the transaction is commands
+      wire->write(commands, chunk);
+      wire->endTransmission();
+      commands += chunk;
+      count -= chunk;
     }
-    display->display(); 
-    delay((long) wholedelaytime / cycles);
-  }
-  
-  if (!state) {
-    display->clearDisplay();
-    display->display();
-    delay(wholedelaytime / cycles);
+#if ARDUINO >= 157
+    wire->setClock(display->*SSD1306Members::restoreClkMember);
+#endif
   }
-}
 
-/// @brief A fade transition using diagonal lines. Fades to either full black or full white/on.
-/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
-/// @param cycles Number of steps for the fade. Using negative values will use the recommended value (`4`).
-/// @param wholedelaytime The duration of the entire fade transition. Using negative values will use the recommended value.
-/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
-void fadeDiagonal(Adafruit_SSD1306* display, int cycles, long wholedelaytime, uint16_t state) {
-  // Recommended values
-  if (cycles < 0) cycles = 4;
-  if (wholedelaytime < 0) wholedelaytime = 25 * cycles;
-  
-  for(int i=0; i<cycles; i++) {
-    for(int j=i; j<display->width()+display->height(); j+=cycles) {
-      display->drawLine(0, j, j, 0, state);
-    }
-    display->display(); 
-    delay((long) wholedelaytime / cycles);
+  else if (spi) {
+#if defined(SPI_HAS_TRANSACTION)
+    spi->beginTransaction(display->*SSD1306Members::spiSettingsMember);
+#endif
+    digitalWrite(display->*SSD1306Members::csPinMember, LOW);
+    digitalWrite(display->*SSD1306Members::dcPinMember, LOW);
+    while (count--) spi->transfer(*commands++);
+    digitalWrite(display->*SSD1306Members::csPinMember, HIGH);
+#if defined(SPI_HAS_TRANSACTION)
+    spi->endTransaction();
+#endif
   }
-  
-  if (!state) {
-    display->clearDisplay();
-    display->display();
-    delay(wholedelaytime / cycles);
+
+  else {
+    while (count--) display->ssd1306_command(*commands++);
   }
 }
 
+// Sets the GDDRAM window that the following data bytes will fill, in a single command transaction.
+static void openWindow(Adafruit_SSD1306* display, uint8_t startcol, uint8_t endcol, uint8_t startpage, uint8_t endpage) {
+  uint8_t commands[] = {
+    SSD1306_COLUMNADDR, (uint8_t) (startcol + getColumnOffset(display)), (uint8_t) (endcol + getColumnOffset(display)),
+    SSD1306_PAGEADDR, startpage, endpage,
+  };
+  sendCommands(display, commands, sizeof(commands));
+}
+
+// The regular `display()` flush: six address commands, then the whole framebuffer. Panels with a column offset get the
+// frame through an address window of their own instead, so full and partial flushes always land on the same columns.
+static void sendFullFrame(Adafruit_SSD1306* display) {
+  uint8_t width = getPanelWidth(display);
+  uint8_t pages = getPageCount(display);
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  if (getColumnOffset(display) && hasBus(display)) {
+    openWindow(display, 0, width - 1, 0, pages - 1);
+    sendData(display, display->getBuffer(), width * pages);
+    return;
+  }
 
-// IMAGE PROCESSING FUNCTIONS
+  selectDisplay(display);
+  display->display();
+  countBytes(display, 6 + width * pages);
+}
 
-/// @brief Fades the screen to full white/on with the `fadeGrid` effect, then draws the target bitmap/image with the `fadeCross` effect at specified (x,y) location.
+/// @brief Sets a hook that selects the display's channel before the library talks to it, e.g. on a TCA9548A I2C multiplexer. The hook is only called when the channel changes.
 /// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
-/// @param delaytime Number of milliseconds taken per step in the 3-step initial fade. Using negative values will use the recommended value (`50`).
-/// @param initdelaytime Number of milliseconds to wait after the initial fade before drawing the bitmap. Using negative values will use the recommended value (`500`).
-/// @param offset_x The x-coordinate of the image, starting at top-left.
-/// @param offset_y The y-coordinate of the image, starting at top-left.
-/// @param bmp The bitmap to be drawn.
-void fadeInGridBitmap(Adafruit_SSD1306* display, long delaytime, long initdelaytime, int16_t offset_x, int16_t offset_y, Image bmp) {
-  // Recommended values
-  if (delaytime < 0) delaytime = 50;
-  if (initdelaytime < 0) initdelaytime = 500;
-  
-  fadeGrid(display, delaytime, ON);
-  delay(initdelaytime);
+/// @param select The hook, or `NULL` to remove it. Calls the library does not make, like the display's own `begin()`, still need the channel selected by the sketch.
+/// @param channel Passed to the hook, e.g. the multiplexer port the display is on.
+void setDisplaySelect(Adafruit_SSD1306* display, DisplaySelect select, uint8_t channel) {
+  DisplayState* state = getDisplayState(display);
+  if (!state) return;
+
+  state->select = select;
+  state->channel = channel;
+  if (selectedHook == select) selectedHook = NULL;   // The hook's channel may have been switched behind our back
+}
 
-  for(int i=0; i<display->width(); i+=2) {
-    display->drawFastVLine(i, 0, display->height(), OFF);
+/// @brief Sets the bus clock the display's transfers run at, including its own `display()`. Many panels run I2C at fast-mode plus (`1000000`), past the 400 kHz the SSD1306 is specified for, when the board and pull-ups allow it.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object, after `begin()`.
+/// @param hz The clock to ask for, in Hz.
+/// @return The clock the bus will actually run at, which is the nearest one the hardware can divide down to, or `0` if it cannot be set: software SPI, or cores too old to change it.
+uint32_t setBusClock(Adafruit_SSD1306* display, uint32_t hz) {
+  if (!hz) return 0;
+
+  if (display->*SSD1306Members::wireMember) {
+#if ARDUINO >= 157
+#if defined(__AVR__) && defined(TWBR)
+    // The TWI divides F_CPU by 16 + 2 * TWBR, an 8-bit register; Wire rounds the divider down, which rounds the clock up
+    uint32_t twbr = hz < F_CPU / 16 ? (F_CPU / hz - 16) / 2 : 0;
+    if (twbr > 255) twbr = 255;
+    hz = F_CPU / (16 + 2 * twbr);
+#endif
+    display->*SSD1306Members::wireClkMember = hz;
+#if defined(ESP32)
+    // The ESP32 driver picks its own divider, so ask it what it got
+    TwoWire* wire = display->*SSD1306Members::wireMember;
+    wire->setClock(hz);
+    hz = wire->getClock();
+    wire->setClock(display->*SSD1306Members::restoreClkMember);
+#endif
+    return hz;
+#else
+    return 0;
+#endif
   }
-  display->drawBitmap(offset_x, offset_y, bmp.bitmap, bmp.width, bmp.height, ON);
-  display->display(); 
-  delay(delaytime);
-  
-  for(int i=0; i<display->height(); i+=2) {
-    display->drawFastHLine(0, i, display->width(), OFF);
+
+  if (display->*SSD1306Members::spiMember) {
+#if defined(SPI_HAS_TRANSACTION)
+#if defined(__AVR__)
+    // SPI divides F_CPU by a power of two from 2 to 128, the fastest clock not above `hz`
+    uint32_t divided = F_CPU / 2;
+    while (divided > hz && divided > F_CPU / 128) divided /= 2;
+    hz = divided;
+#endif
+    display->*SSD1306Members::spiSettingsMember = SPISettings(hz, MSBFIRST, SPI_MODE0);
+    return hz;
+#else
+    return 0;
+#endif
   }
-  display->drawBitmap(offset_x, offset_y, bmp.bitmap, bmp.width, bmp.height, ON);
-  display->display(); 
-  delay(delaytime);
 
-  for(int i=1; i<display->height(); i+=2) {
-    display->drawFastHLine(0, i, display->width(), OFF);
+  return 0;
+}
+
+// Maps a rectangle from screen coordinates onto the unrotated panel and clips it to the tracked pages. Returns `false` if
+// nothing of it is left.
+static bool mapToPanel(Adafruit_SSD1306* display, int16_t& x, int16_t& y, int16_t& w, int16_t& h) {
+  int16_t panelwidth = getPanelWidth(display);
+  int16_t panelheight = getPanelHeight(display);
+  int16_t t;
+  switch (display->getRotation()) {
+    case 1: t = x; x = panelwidth - y - h; y = t; t = w; w = h; h = t; break;
+    case 2: x = panelwidth - x - w; y = panelheight - y - h; break;
+    case 3: t = x; x = y; y = panelheight - t - w; t = w; w = h; h = t; break;
   }
-  display->drawBitmap(offset_x, offset_y, bmp.bitmap, bmp.width, bmp.height, ON);
-  display->display(); 
-  delay(delaytime);
+
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > panelwidth) w = panelwidth - x;
+  if (y + h > getPageCount(display) * 8) h = getPageCount(display) * 8 - y;
+  return w > 0 && h > 0;
 }
 
-/// @brief Draws a bitmap, then scrolls it vertically to the specified y-coordinate.
+// Marks columns `startcol` to `endcol` of one panel page.
+static void markPanelDirty(DisplayState* state, uint8_t page, uint8_t startcol, uint8_t endcol) {
+  if (startcol < state->dirtyStart[page]) state->dirtyStart[page] = startcol;
+  if (endcol > state->dirtyEnd[page]) state->dirtyEnd[page] = endcol;
+}
+
+/// @brief Marks a rectangle of the framebuffer as changed, so the next `flushDirty` call sends it to the display.
 /// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
-/// @param initialdelay Number of milliseconds to wait between drawing and scrolling the bitmap. Using negative values will use the recommended value (`500`).
-/// @param enddelay Number of milliseconds to delay after reaching the end of scrolling. Using negative values will use the recommended value (`500`).
-/// @param scrolldelay Number of milliseconds taken to scroll by one step. Using negative values will use the recommended value (`5`).
-/// @param scrollstep Number of pixels to skip per scrolling step. If `1`, scroll row by row; if `2`, skip every other row; etc. Use positive values for scrolling down, or negative values for scrolling up.
-/// @param snaptoend If `false`, and `scrollstep > 1`, `scrollstep` will revert to `1` once the remaining rows to scroll is less than `scrollstep`. 
-/// @param allowoverflow  If `false`, scrolling will not exceed the bottom of the bitmap. Useful when bitmap height is not divisible by `scrollstep`. 
-/// @param offset_x The x-coordinate of the image, starting at top-left. If this function is used with `fadeInGridBitmap`, use the `offset_x` value passed there.
-/// @param offset_y The x-coordinate of the image, starting at top-left. If this function is used with `fadeInGridBitmap`, use the `offset_y` value passed there.
-/// @param end_y A value "n" where scrolling will stop. For scroll-down, nth row from the bottom, and for scroll-up, nth row from the top.
-/// @param bmp The bitmap to be drawn.
-void drawVerticalScrollingBitmap(Adafruit_SSD1306* display, long initialdelay, long enddelay, long scrolldelay, int scrollstep, bool snaptoend, bool allowoverflow, int16_t offset_x, int16_t offset_y, int16_t end_y, Image bmp) {
-  // Recommended/default values
-  if (initialdelay < 0) initialdelay = 500;
-  if (enddelay < 0) enddelay = 500;
-  if (scrolldelay < 0) scrolldelay = 5;
+/// @param x The x-coordinate of the rectangle, starting at top-left.
+/// @param y The y-coordinate of the rectangle, starting at top-left.
+/// @param w Width of the rectangle, in pixels.
+/// @param h Height of the rectangle, in pixels.
+void markDirty(Adafruit_SSD1306* display, int16_t x, int16_t y, int16_t w, int16_t h) {
+  DisplayState* state = getDisplayState(display);
+  if (!state) return;   // untracked displays are always flushed in full
+  if (!mapToPanel(display, x, y, w, h)) return;
+
+  for (uint8_t page = y / 8; page <= (y + h - 1) / 8; page++) markPanelDirty(state, page, x, x + w - 1);
+}
 
-  // Modify end_y values internally to be the absolute y-coordinate where scrolling will stop
-  // TODO: Review this 
-  if (scrollstep > 0 && end_y <= 0) end_y = bmp.height;
-  else if (scrollstep > 0 && end_y + 64 > bmp.height && !allowoverflow) end_y = bmp.height;
-  else if (scrollstep > 0) end_y += 64;
-  else if (scrollstep < 0 && end_y + 64 > bmp.height && !allowoverflow) end_y = bmp.height - 64;
-  else if (scrollstep < 0 && end_y < 0 && !allowoverflow) end_y = 0;
-  
-  display->drawBitmap(offset_x, offset_y, bmp.bitmap, bmp.width, bmp.height, ON);
-  display->display();
-  delay(initialdelay);
+/// @brief Checks whether anything has been marked by `markDirty` since the last flush.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @return `true` if a flush is pending. Displays beyond `SSD1306FUNC_MAX_DISPLAYS` always report `true`.
+bool isDirty(Adafruit_SSD1306* display) {
+  DisplayState* state = getDisplayState(display);
+  if (!state) return true;
 
-  if (scrollstep > 0) {
-    int height = 0;
-    while (height + 64 - offset_y < end_y) {
-      display->drawBitmap(offset_x, -height + offset_y, bmp.bitmap, bmp.width, bmp.height, OFF);
+  for (uint8_t page = 0; page < SSD1306FUNC_MAX_PAGES; page++) {
+    if (state->dirtyStart[page] != 0xFF) return true;
+  }
+  return false;
+}
+
+// Whether every page is marked from the first column to the last, in which case one full flush is cheapest.
+static bool isFullyDirty(DisplayState* state, uint8_t pages, uint8_t lastcol) {
+  for (uint8_t page = 0; page < pages; page++) {
+    if (state->dirtyStart[page] != 0 || state->dirtyEnd[page] != lastcol) return false;
+  }
+  return true;
+}
 
-      if (height + 64 - offset_y + scrollstep < end_y) height+=scrollstep;
-      else if (height + 64 - offset_y < end_y && !snaptoend) height++;
-      else break;
+// Splits the marked pages into address windows, returning how many were written to `windows`.
+static uint8_t collectWindows(DisplayState* state, uint8_t pages, FlushWindow* windows) {
+  uint8_t count = 0;
+  uint8_t page = 0;
 
-      display->drawBitmap(offset_x, -height + offset_y, bmp.bitmap, bmp.width, bmp.height, ON);
-      display->display();
-      delay(scrolldelay);
+  while (page < pages) {
+    if (state->dirtyStart[page] == 0xFF) {
+      page++;
+      continue;
     }
 
-    display->drawBitmap(offset_x, -(end_y - 64), bmp.bitmap, bmp.width, bmp.height, ON);
-    display->display();
-    delay(enddelay);
-  } else if (scrollstep < 0) {
-    int height = offset_y;
-    while (height < -end_y) {
-      display->drawBitmap(offset_x, height, bmp.bitmap, bmp.width, bmp.height, OFF);
+    uint8_t first = page;
+    uint8_t start = state->dirtyStart[page];
+    uint8_t end = state->dirtyEnd[page];
 
-      if (height - scrollstep <= -end_y) height-=scrollstep;
-      else if (height <= -end_y && !snaptoend) height++;
-      else break;
+    // Grow the window down while sending the union costs less than opening a separate window
+    while (page + 1 < pages && state->dirtyStart[page + 1] != 0xFF) {
+      uint8_t nextstart = state->dirtyStart[page + 1];
+      uint8_t nextend = state->dirtyEnd[page + 1];
+      uint8_t unionstart = nextstart < start ? nextstart : start;
+      uint8_t unionend = nextend > end ? nextend : end;
 
-      display->drawBitmap(offset_x, height, bmp.bitmap, bmp.width, bmp.height, ON);
-      display->display();
-      delay(scrolldelay);
+      uint16_t merged = (uint16_t) (unionend - unionstart + 1) * (page + 2 - first);
+      uint16_t separate = (uint16_t) (end - start + 1) * (page + 1 - first) + (nextend - nextstart + 1) + WINDOW_COST;
+      if (merged > separate) break;
+
+      start = unionstart;
+      end = unionend;
+      page++;
     }
 
-    display->drawBitmap(offset_x, -end_y, bmp.bitmap, bmp.width, bmp.height, ON);
-    display->display();
-    delay(enddelay);
+    FlushWindow window = {start, end, first, page};
+    windows[count++] = window;
+    page++;
   }
-}
-
-
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// VISUAL NOVEL-ESQUE FUNCTIONS
+  return count;
+}
 
-// TEXT PROCESSING FUNCTIONS
+/// @brief Sends only the framebuffer pages and columns marked by `markDirty` since the last flush.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+void flushDirty(Adafruit_SSD1306* display) {
+  finishFlush(display);
+
+  DisplayState* state = getDisplayState(display);
+  uint8_t pages = getPageCount(display);
+  uint8_t lastcol = getPanelWidth(display) - 1;
+
+  // Untracked displays and software SPI (no bus handle to write through) use the regular full flush
+  if (!state || !hasBus(display)) {
+    sendFullFrame(display);
+    if (state) clearDirty(state);
+    return;
+  }
 
-/// @brief Draws the specified dialog text with a header label. Allows both instant and animated text display. Uses serial monitor to invoke click-to-confirm (CTC).
-/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
-/// @param textspeed A positive integer, at least `1`. Number of characters revealed in one step. Only useful when `onebyone` is `true`. Using negative values will use the recommended value (`1`).
-/// @param chardelay Number of milliseconds taken to reveal a step. Using negative values will use the recommended value. Only useful when `onebyone` is `true`. Using negative values will use the recommended value (`10`).
-/// @param headerdelay Number of milliseconds to wait after showing header label before displaying the dialog text. Using negative values will use the recommended value (`200`).
-/// @param onebyone If `true`, animate the text display by revealing n characters at a time, with n = `textspeed`.  
-/// @param headertext A string literal, the header label.
-/// @param dialog A string literal, the dialog to be displayed. Use the " ` " character to invoke CTC midway through a dialog.
-void drawDialogText(Adafruit_SSD1306* display, uint8_t textspeed, long chardelay, long headerdelay, uint8_t onebyone, const char* headertext, const char* dialog) {
-  // Recommended values
-  if (textspeed <= 0) textspeed = 1;
-  if (chardelay < 0) chardelay = 10;
-  if (headerdelay < 0) headerdelay = 200;
+  if (isFullyDirty(state, pages, lastcol)) {
+    sendFullFrame(display);
+    clearDirty(state);
+    return;
+  }
 
-  int size = strlen(dialog);
+  FlushWindow windows[SSD1306FUNC_MAX_PAGES];
+  uint8_t count = collectWindows(state, pages, windows);
+  for (uint8_t i = 0; i < count; i++) {
+    flushWindow(display, windows[i].startcol, windows[i].endcol, windows[i].startpage, windows[i].endpage);
+  }
 
-  display->setCursor(0, 0);
-  display->write(headertext);
-  display->display();
-  delay(headerdelay);
-
-  display->setCursor(0, 16);
-
-  if (onebyone) {
-    int i = 0;
-    while (i + textspeed < size) {
-      for (int x = 0; x < textspeed; x++) {
-        if (dialog[i+x] != '`') display->write(dialog[i+x]);
-        else {
-          display->display();
-          delay(chardelay);
-          ctcSerial(display);
-        }
-      }
+  clearDirty(state);
+}
 
-      display->display();
-      delay(chardelay);
-      i += textspeed;
+/// @brief Starts sending the changes marked by `markDirty` and returns before the transfer is done; `pumpFlush()` sends the rest. The changes are copied aside first, so drawing can carry on at once. Same as `flushDirty` unless `SSD1306FUNC_ASYNC_FLUSH` is `1`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+void startFlush(Adafruit_SSD1306* display) {
+#if SSD1306FUNC_ASYNC_FLUSH
+  // The previous changes have to be out before their copy is reused
+  finishFlush(display);
+
+  DisplayState* state = getDisplayState(display);
+  uint8_t pages = getPageCount(display);
+  uint8_t width = getPanelWidth(display);
+  if (state && hasBus(display) && !state->front) state->front = (uint8_t*) malloc(width * pages);
+
+  if (state && hasBus(display) && state->front) {
+    uint8_t* buffer = display->getBuffer();
+
+    if (isFullyDirty(state, pages, width - 1)) {
+      FlushWindow window = {0, (uint8_t) (width - 1), 0, (uint8_t) (pages - 1)};
+      state->windows[0] = window;
+      state->windowCount = 1;
+    } else {
+      state->windowCount = collectWindows(state, pages, state->windows);
     }
 
-    while (i < size) {
-      if (dialog[i] != '`') {
-        display->write(dialog[i]);
-        display->display();
-        delay(chardelay); 
+    for (uint8_t i = 0; i < state->windowCount; i++) {
+      FlushWindow* window = &state->windows[i];
+      for (uint8_t page = window->startpage; page <= window->endpage; page++) {
+        uint16_t offset = page * width + window->startcol;
+        memcpy(state->front + offset, buffer + offset, window->endcol - window->startcol + 1);
       }
-      else ctcSerial(display);
-      i++;
     }
-  } 
-  
-  else {
-    display->write(dialog);
-    display->display();
-    delay(1);
+
+    state->windowIndex = 0;
+    state->windowOpen = false;
+    clearDirty(state);
+    pumpFlush(display);
+    return;
   }
+#endif
 
-  ctcSerial(display);
+  flushDirty(display);
 }
 
-/// @brief Draws the specified dialog text with a header label. Allows both instant and animated text display. Uses serial monitor to invoke click-to-confirm (CTC), or a timer for auto-progression.
-/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
-/// @param textspeed A positive integer, at least `1`. Number of characters revealed in one step. Only useful when `onebyone` is `true`. Using negative values will use the recommended value (`1`).
-/// @param chardelay Number of milliseconds taken to reveal a step. Using negative values will use the recommended value. Only useful when `onebyone` is `true`. Using negative values will use the recommended value (`10`).
-/// @param headerdelay Number of milliseconds to wait after showing header label before displaying the dialog text. Using negative values will use the recommended value (`200`).
-/// @param timer Number of milliseconds for the timed CTC. Using negative values will use the recommended value (`10000`).
-/// @param timedinput If `true`, enable timer aside from serial monitor for midway CTCs. Otherwise, only use serial monitor. 
-/// @param timedend If `true`, enable timer aside from serial monitor for CTC at the end of the dialog. Otherwise, only use serial monitor.
-/// @param onebyone If `true`, animate the text display by revealing n characters at a time, with n = `textspeed`.  
-/// @param headertext A string literal, the header label.
-/// @param dialog A string literal, the dialog to be displayed. Use the " ` " character to invoke CTC midway through the dialog.
-void drawTimedDialogText(Adafruit_SSD1306* display, uint8_t textspeed, long chardelay, long headerdelay, long timer, uint8_t timedinput, uint8_t timedend, uint8_t onebyone, const char* headertext, const char* dialog) {
-  // Recommended values
-  if (textspeed <= 0) textspeed = 1;
-  if (chardelay < 0) chardelay = 10;
-  if (headerdelay < 0) headerdelay = 200;
-  if (timer < 0) timer = 10000;
-
-  int size = strlen(dialog);
-
-  display->setCursor(0, 0);
-  display->write(headertext);
-  display->display();
-  delay(headerdelay);
-
-  display->setCursor(0, 16);
-
-  if (onebyone) {
-    int i = 0;
-    while (i + textspeed < size) {
-      for (int x = 0; x < textspeed; x++) {
-        if (dialog[i+x] != '`') display->write(dialog[i+x]);
-        else {
-          display->display();
-          delay(chardelay);
-          if (timedinput) ctcTimedSerial(display, timer);
-          else ctcSerial(display);
-        }
-      }
-
-      display->display();
-      delay(chardelay);
-      i += textspeed;
-    }
+/// @brief Sends the next chunk of a transfer begun by `startFlush()`. Call it whenever there is time to spare.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @return `true` while part of the transfer is still left to send.
+bool pumpFlush(Adafruit_SSD1306* display) {
+#if SSD1306FUNC_ASYNC_FLUSH
+  DisplayState* state = getDisplayState(display);
+  if (!state || !state->front || state->windowIndex >= state->windowCount) return false;
+
+  FlushWindow* window = &state->windows[state->windowIndex];
+  if (!state->windowOpen) {
+    openWindow(display, window->startcol, window->endcol, window->startpage, window->endpage);
+    state->sendPage = window->startpage;
+    state->sendCol = window->startcol;
+    state->windowOpen = true;
+  }
 
-    while (i < size) {
-      if (dialog[i] != '`') {
-        display->write(dialog[i]);
-        display->display();
-        delay(chardelay); 
-      }
-      else {
-        if (timedinput) ctcTimedSerial(display, timer);
-        else ctcSerial(display);
-      }
-      i++;
+  // The controller advances through the window by itself, so each chunk simply carries on where the last one stopped
+  uint8_t count = window->endcol - state->sendCol + 1;
+  if (count > FLUSH_CHUNK) count = FLUSH_CHUNK;
+  sendData(display, state->front + state->sendPage * getPanelWidth(display) + state->sendCol, count);
+
+  state->sendCol += count;
+  if (state->sendCol > window->endcol) {
+    state->sendCol = window->startcol;
+    if (++state->sendPage > window->endpage) {
+      state->windowIndex++;
+      state->windowOpen = false;
     }
-  } 
-  
-  else {
-    display->write(dialog);
-    display->display();
-    delay(1);
   }
+  return state->windowIndex < state->windowCount;
+#else
+  return false;
+#endif
+}
 
-  if (timedend) ctcTimedSerial(display, timer);
-  else ctcSerial(display);
+#if SSD1306FUNC_SLEEP
+// Whether a transfer begun by `startFlush()` still has chunks left to send.
+static bool isSending(Adafruit_SSD1306* display) {
+#if SSD1306FUNC_ASYNC_FLUSH
+  DisplayState* state = getDisplayState(display);
+  return state && state->front && state->windowIndex < state->windowCount;
+#else
+  return false;
+#endif
 }
+#endif
 
+/// @brief Blocks until a transfer begun by `startFlush()` has been sent in full.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+void finishFlush(Adafruit_SSD1306* display) {
+  while (pumpFlush(display));
+}
 
-/// @brief Clears the header label on a displayed dialog screen. 
-/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
-void clearHeaderText(Adafruit_SSD1306* display) {
-  display->fillRect(0, 0, 128, 16, OFF);
-  display->display();
-  delay(1);
+/// @brief Marks the whole screen as changed and flushes it. Equivalent to `display->display()`, but keeps the dirty tracking in sync.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+void flushScreen(Adafruit_SSD1306* display) {
+  markDirty(display, 0, 0, display->width(), display->height());
+  flushDirty(display);
 }
 
-/// @brief Clears the dialog section on a displayed dialog screen.
-/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
-void clearDialogText(Adafruit_SSD1306* display) {
-  display->fillRect(0, 16, 128, 48, OFF);
-  display->display();
-  delay(1);
+/// @brief Sends a rectangular window of the framebuffer to the display using the controller's column/page address commands.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param startcol First column of the window.
+/// @param endcol Last column of the window, inclusive.
+/// @param startpage First 8-row page of the window.
+/// @param endpage Last 8-row page of the window, inclusive.
+void flushWindow(Adafruit_SSD1306* display, uint8_t startcol, uint8_t endcol, uint8_t startpage, uint8_t endpage) {
+  finishFlush(display);
+
+  uint8_t* buffer = display->getBuffer();
+  uint8_t width = getPanelWidth(display);
+
+  openWindow(display, startcol, endcol, startpage, endpage);
+  for (uint8_t page = startpage; page <= endpage; page++) {
+    sendData(display, buffer + page * width + startcol, endcol - startcol + 1);
+  }
 }
 
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// DELAY/INPUT FUNCTIONS
+// TEXT FUNCTIONS
 
-/// @brief Use serial monitor to wait for a user input. Displays a CTC indicator at the bottom-right corner.
-/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
-void ctcSerial(Adafruit_SSD1306* display) {
-  int baseX = display->getCursorX();
-  int baseY = display->getCursorY();
-  uint8_t color = 0;
+// A built-in font glyph as the five column bytes `drawChar()` draws at size 1, top pixel in bit 0.
+typedef struct GlyphCacheEntry {
+  char c;
+  uint8_t columns[5];
+} GlyphCacheEntry;
 
-  while (Serial.available()) Serial.read();   // clear any serial artifacts
+static GlyphCacheEntry glyphCache[SSD1306FUNC_GLYPH_CACHE];
+static uint8_t glyphCacheCount, glyphCacheNext;
+static bool glyphCacheCp437;                  // The `cp437()` setting the cached glyphs were drawn with.
 
-  long prev = millis();
-  long now;
+// Catches the pixels `Adafruit_GFX::drawChar()` draws for one built-in glyph. The font table itself is private to
+// Adafruit_GFX, so glyphs are packed this way instead of keeping a second copy of the font in flash.
+struct GlyphCatcher : public Adafruit_GFX {
+  uint8_t columns[5];
 
-  while(!Serial.available()) {
-    now = millis();
-    if (now - prev > 500) {
-      prev = now;
-      color = !color;
-      display->setCursor(116, 0);
-      display->setTextColor(color);
-      display->write(">>");
-      display->display();
-    }
+  GlyphCatcher() : Adafruit_GFX(5, 8) {
+    memset(columns, 0, sizeof(columns));
   }
 
-  display->setCursor(116, 0);
-  display->setTextColor(0);
-  display->write(">>");
-  display->display();
-
-  while (Serial.available()) Serial.read();   // clear serial buffer for next CTC call
-  display->setCursor(baseX, baseY);
-  display->setTextColor(1);
-}
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (x >= 0 && x < 5 && y >= 0 && y < 8) columns[x] |= 1 << y;
+  }
+};
+
+// Returns the column bytes of a built-in font glyph, packing it into the cache first if it is not there yet.
+static const uint8_t* getBuiltinGlyph(Adafruit_SSD1306* display, char c) {
+  bool cp437 = display->*SSD1306Members::cp437Member;
+  if (cp437 != glyphCacheCp437) {
+    glyphCacheCount = glyphCacheNext = 0;
+    glyphCacheCp437 = cp437;
+  }
 
-/// @brief Use serial monitor to wait for a user input, or use a timer. Displays a CTC indicator at the bottom-right corner.
-/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
-/// @param timerMS CTC timer, in milliseconds.
-void ctcTimedSerial(Adafruit_SSD1306* display, long timerMS) {
-  int baseX = display->getCursorX();
-  int baseY = display->getCursorY();
-  uint8_t color = 0;
-
-  while (Serial.available()) Serial.read();   // clear any serial artifacts
-  
-  long basetime = millis();
-  long prev = millis();
-  long now = millis();
-
-  while(!Serial.available() && now - basetime < timerMS) {
-    now = millis();
-    if (now - prev > 500) {
-      prev = now;
-      color = !color;
-      display->setCursor(116, 0);
-      display->setTextColor(color);
-      display->write(">>");
-      display->display();
-    }
+  for (uint8_t i = 0; i < glyphCacheCount; i++) {
+    if (glyphCache[i].c == c) return glyphCache[i].columns;
   }
 
-  display->setCursor(116, 0);
-  display->setTextColor(0);
-  display->write(">>");
-  display->display();
+  GlyphCatcher catcher;
+  catcher.cp437(cp437);
+  catcher.drawChar(0, 0, c, ON, ON, 1);
+
+  // Oldest entry first once the cache is full
+  GlyphCacheEntry* entry = &glyphCache[glyphCacheNext];
+  glyphCacheNext = (glyphCacheNext + 1) % SSD1306FUNC_GLYPH_CACHE;
+  if (glyphCacheCount < SSD1306FUNC_GLYPH_CACHE) glyphCacheCount++;
+  entry->c = c;
+  memcpy(entry->columns, catcher.columns, sizeof(entry->columns));
+  return entry->columns;
+}
 
-  while (Serial.available()) Serial.read();   // clear serial buffer for next CTC call
-  display->setCursor(baseX, baseY);
-  display->setTextColor(1);
+static const GlyphFont* getGlyphFont(Adafruit_SSD1306* display) {
+  DisplayState* state = getDisplayState(display);
+  return state ? state->glyphFont : NULL;
 }
 
+// Writes one character at the cursor and advances it, like `display->write(c)`. Page-aligned text at size 1 on an unrotated
+// display has its glyph columns copied straight into the framebuffer page; anything else goes through Adafruit_GFX, or for a
+// `GlyphFont`, through `drawPixel()`. `font` is the `GlyphFont` to use, or `NULL` for the display's own font.
+static void writeChar(Adafruit_SSD1306* display, const GlyphFont* font, char c) {
+  if (!font && (display->*SSD1306Members::gfxFontMember || display->*SSD1306Members::textsizeXMember != 1 || display->*SSD1306Members::textsizeYMember != 1)) {
+    display->write(c);
+    return;
+  }
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  if (c == '\n' || c == '\r') {
+    if (!font) display->write(c);
+    else if (c == '\n') display->setCursor(0, display->getCursorY() + 8);
+    return;
+  }
 
-// EXPERIMENTAL
+  uint8_t width = 5, advance = 6;
+  if (font) {
+    if ((uint8_t) c < font->first || (uint8_t) c > font->last) return;
+    width = font->width;
+    advance = font->advance;
+  }
 
-// CTC functions that use GPIO inputs instead of serial monitor for user input
+  int16_t x = display->getCursorX();
+  int16_t y = display->getCursorY();
+  if (display->*SSD1306Members::wrapMember && x + advance > display->width()) {
+    x = 0;
+    y += 8;
+  }
 
-void ctc(Adafruit_SSD1306* display, uint8_t button) {
-  int baseX = display->getCursorX();
-  int baseY = display->getCursorY();
-  uint8_t color = 0;
+  // The fast path covers the colors the SSD1306 draws: transparent text in any of them, or black on white and white on black
+  uint16_t color = display->*SSD1306Members::textcolorMember;
+  uint16_t bg = display->*SSD1306Members::textbgcolorMember;
+  bool opaque = bg != color;
+  bool direct = !display->getRotation() && x >= 0 && x + advance <= display->width() && y >= 0 && y + 8 <= display->height() && !(y & 7)
+    && color <= SSD1306_INVERSE && (!opaque || (color <= ON && bg <= ON));
+  if (!direct && !font) {
+    display->write(c);
+    return;
+  }
 
-  while(digitalRead(button)) continue;
+  const uint8_t* columns = font ? font->columns + ((uint8_t) c - font->first) * width : getBuiltinGlyph(display, c);
+  uint8_t* dest = display->getBuffer() + (y / 8) * getPanelWidth(display) + x;
+  display->setCursor(x + advance, y);
 
-  long prev = millis();
-  long now;
+  for (uint8_t i = 0; i < advance; i++) {
+    uint8_t bits = i >= width ? 0 : font ? pgm_read_byte(columns + i) : columns[i];
 
-  while(!digitalRead(button)) {
-    now = millis();
-    if (now - prev > 500) {
-      prev = now;
-      color = !color;
-      display->setCursor(116, 0);
-      display->setTextColor(color);
-      display->write(">>");
-      display->display();
+    if (!direct) {
+      for (uint8_t j = 0; j < 8; j++) {
+        if (bits & (1 << j)) display->drawPixel(x + i, y + j, color);
+        else if (opaque) display->drawPixel(x + i, y + j, bg);
+      }
     }
+    else if (opaque) dest[i] = color ? bits : ~bits;
+    else if (color == ON) dest[i] |= bits;
+    else if (color == OFF) dest[i] &= ~bits;
+    else dest[i] ^= bits;
   }
+}
 
-  display->setCursor(116, 0);
-  display->setTextColor(0);
-  display->write(">>");
-  display->display();
+// Marks the text written since the cursor was at (`startx`,`starty`). Wrapped text marks every line it touched in full.
+static void markTextDirty(Adafruit_SSD1306* display, int16_t startx, int16_t starty) {
+  int16_t endx = display->getCursorX();
+  int16_t endy = display->getCursorY();
 
-  while (Serial.available()) Serial.read();   // clear serial buffer for next CTC call
-  display->setCursor(baseX, baseY);
-  display->setTextColor(1);
+  if (endy == starty) markDirty(display, startx, starty, endx - startx, 8);
+  else markDirty(display, 0, starty, display->width(), endy - starty + 8);
 }
 
-void ctcTimed(Adafruit_SSD1306* display, uint8_t button, long timerMS) {
-  int baseX = display->getCursorX();
-  int baseY = display->getCursorY();
-  uint8_t color = 0;
-
-  while (Serial.available()) Serial.read();   // clear any serial artifacts
-  
-  long basetime = millis();
-  long prev = millis();
-  long now = millis();
-
-  while(!Serial.available() && now - basetime < timerMS) {
-    now = millis();
-    if (now - prev > 500) {
-      prev = now;
+// Writes one character and marks only its glyph cell. With the built-in font or a `GlyphFont`, that is the cell (times the
+// text size) ending at the new cursor, even when the character wrapped onto the next line; custom fonts mark the text span instead.
+static void writeDialogChar(Adafruit_SSD1306* display, char c) {
+  int16_t x = display->getCursorX();
+  int16_t y = display->getCursorY();
+  const GlyphFont* font = getGlyphFont(display);
+
+  writeChar(display, font, c);
+  if (!font && display->*SSD1306Members::gfxFontMember) {
+    markTextDirty(display, x, y);
+    return;
+  }
+
+  if (c == '\n' || c == '\r') return;
+  uint8_t sizex = font ? 1 : display->*SSD1306Members::textsizeXMember;
+  uint8_t sizey = font ? 1 : display->*SSD1306Members::textsizeYMember;
+  uint8_t advance = font ? font->advance : 6;
+  markDirty(display, display->getCursorX() - advance * sizex, display->getCursorY(), advance * sizex, 8 * sizey);
+}
+
+/// @brief Writes text at the cursor, like `display->print()`, and marks it for the next partial flush. Page-aligned text at size 1 (y = 0, 8, 16...) is copied into the framebuffer a column at a time instead of pixel by pixel.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param text The text to write.
+void writeText(Adafruit_SSD1306* display, const char* text) {
+  int16_t x = display->getCursorX();
+  int16_t y = display->getCursorY();
+  const GlyphFont* font = getGlyphFont(display);
+
+  while (*text) writeChar(display, font, *text++);
+  markTextDirty(display, x, y);
+}
+
+/// @brief Sets a compact font for `writeText()` and the dialog functions to use instead of the display's own. `GlyphFont` glyphs are always drawn at size 1.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param font The font, e.g. from `tools/ssd1306img.py --format font`, or `NULL` to go back to the display's own font.
+void setGlyphFont(Adafruit_SSD1306* display, const GlyphFont* font) {
+  DisplayState* state = getDisplayState(display);
+  if (state) state->glyphFont = font;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// FILL SCREEN FUNCTIONS - FOR DEBUG/SCREEN TEST
+
+/// @brief Fills the screen with three passes of interlacing lines. For checking OLED screen dead pixels.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+void fillScreenSlow(Adafruit_SSD1306* display) {
+  int16_t i;
+
+  display->clearDisplay();
+
+  for(i=0; i<display->height(); i+=2) {
+    display->drawFastHLine(0, i, display->width(), ON);
+    markDirty(display, 0, i, display->width(), 1);
+    flushDirty(display);
+    delay(5);
+  }
+  for(i=0; i<display->width(); i+=2) {
+    display->drawFastVLine(i, 0, display->height(), ON);
+    markDirty(display, i, 0, 1, display->height());
+    flushDirty(display);
+    delay(5);
+  }
+  for(i=1; i<display->height(); i+=2) {
+    display->drawFastHLine(0, i, display->width(), ON);
+    markDirty(display, 0, i, display->width(), 1);
+    flushDirty(display);
+    delay(5);
+  }
+}
+
+/// @brief Fills the screen instantly. Used for checking OLED dead pixels.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+void fillScreenFast(Adafruit_SSD1306* display) {
+  display->fillRect(0, 0, display->width(), display->height(), ON);
+  flushScreen(display);
+}
+
+/// @brief Gets the CRC-32 of the framebuffer. Printing it after an effect, before and after changing the code, shows whether the change kept the output identical.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @return The standard (IEEE 802.3) CRC-32 of the framebuffer bytes, in page layout.
+uint32_t getFramebufferCrc(Adafruit_SSD1306* display) {
+  uint8_t* buffer = display->getBuffer();
+  uint16_t size = getPanelWidth(display) * getPageCount(display);
+  uint32_t crc = 0xFFFFFFFF;
+
+  for (uint16_t i = 0; i < size; i++) {
+    crc ^= buffer[i];
+    for (uint8_t bit = 0; bit < 8; bit++) crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+  }
+  return ~crc;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// NON-BLOCKING EFFECT ENGINE
+
+SSD1306Effect::SSD1306Effect() : display(NULL), frame(0), deadline(0), running(false) {}
+
+/// @brief Advances the effect once its deadline has been reached, catching up on frames that are late, and returns immediately otherwise.
+/// @param now The current time in milliseconds, usually `millis()`.
+/// @return `true` while the effect still has frames left to draw.
+bool SSD1306Effect::tick(unsigned long now) {
+  if (!running) return false;
+#if SSD1306FUNC_STATS
+  unsigned long mark = micros();
+#endif
+
+  if ((long) (now - deadline) < 0) {
+    pumpFlush(display);   // Waits are spent sending the previous frame
+#if SSD1306FUNC_STATS
+    stats.flushMicros += micros() - mark;
+#endif
+    return true;
+  }
+
+  // Frames are due at absolute deadlines, so drawing and bus time don't stretch the effect. A frame that is already
+  // late when the previous one has been drawn is drawn on top of it and flushed together, which drops the skipped
+  // frame from the screen but keeps the total duration. A wait of `0` (polling for input) restarts the schedule.
+  long wait;
+  for (;;) {
+    wait = step();
+    frame++;
+#if SSD1306FUNC_STATS
+    if (wait >= 0) {
+      stats.frames++;
+      stats.requestedMillis += wait;
+    }
+#endif
+    if (wait > 0) deadline += wait;
+    else if (wait == 0) deadline = millis();
+    if (wait <= 0 || (long) (millis() - deadline) < 0) break;
+#if SSD1306FUNC_STATS
+    stats.mergedFrames++;
+#endif
+  }
+
+#if SSD1306FUNC_STATS
+  unsigned long drawn = micros();
+  stats.drawMicros += drawn - mark;
+#endif
+
+  // Polling effects leave most ticks clean, so those keep an earlier transfer moving instead
+  if (isDirty(display)) startFlush(display);
+  else pumpFlush(display);
+
+  if (wait < 0) {
+    running = false;
+    finishFlush(display);
+  }
+
+#if SSD1306FUNC_STATS
+  stats.flushMicros += micros() - drawn;
+  if (!running) finishStats();
+#endif
+  return running;
+}
+
+/// @brief Checks whether the effect still has frames left to draw.
+/// @return `true` between `begin()` and the last frame of the effect.
+bool SSD1306Effect::isRunning() {
+  return running;
+}
+
+/// @brief Checks whether the effect is only waiting for an input, with nothing left to draw before it, e.g. a CTC wait. Scenes use the time to draw ahead.
+/// @return `true` while waiting. Effects that draw until they end always return `false`.
+bool SSD1306Effect::isWaiting() {
+  return false;
+}
+
+#if SSD1306FUNC_SLEEP
+// Idles the MCU until the next interrupt. The `millis()` timer fires about every millisecond, so no deadline is overslept.
+static void sleepUntilInterrupt() {
+#if defined(__AVR__)
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  sleep_cpu();
+  sleep_disable();
+#elif defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_ARCH_STM32) || defined(TEENSYDUINO)
+  __asm__ volatile ("wfi");
+#elif defined(ESP32) || defined(ESP8266)
+  delay(1);   // Lets the RTOS idle task run, which light-sleeps when power management is enabled
+#else
+  yield();
+#endif
+}
+#endif
+
+/// @brief Waits between two `tick()` calls. Sleeps until the next interrupt whenever nothing is left to send, and only yields otherwise or when `SSD1306FUNC_SLEEP` is `0`.
+void SSD1306Effect::idle() {
+#if SSD1306FUNC_SLEEP
+  if (running && !isSending(display)) {
+    sleepUntilInterrupt();
+    return;
+  }
+#endif
+  yield();
+}
+
+/// @brief Stops the effect where it is. The framebuffer is left as the last frame drew it.
+void SSD1306Effect::stop() {
+  if (running) {
+    finishFlush(display);
+#if SSD1306FUNC_STATS
+    finishStats();
+#endif
+  }
+  running = false;
+}
+
+// Called by each effect's `begin()` once its parameters are stored. The first frame is due immediately.
+void SSD1306Effect::start(Adafruit_SSD1306* display) {
+  this->display = display;
+  frame = 0;
+  deadline = millis();
+  running = true;
+
+#if SSD1306FUNC_STATS
+  memset(&stats, 0, sizeof(stats));
+  startmillis = deadline;
+  startbytes = getBusBytes(display);
+#endif
+}
+
+#if SSD1306FUNC_STATS
+static EffectStats lastEffectStats;
+
+void SSD1306Effect::finishStats() {
+  stats.actualMillis = millis() - startmillis;
+  stats.bytes = getBusBytes(display) - startbytes;
+  lastEffectStats = stats;
+}
+
+/// @brief Reads the statistics collected so far. Only available when `SSD1306FUNC_STATS` is `1`.
+/// @return The frame count, draw and flush time, bus bytes and durations of this run of the effect.
+EffectStats SSD1306Effect::getStats() {
+  return stats;
+}
+
+/// @brief Reads the statistics of the last effect that finished, e.g. the one inside the last `fadeVertical` call. Only available when `SSD1306FUNC_STATS` is `1`.
+/// @return The frame count, draw and flush time, bus bytes and durations of that effect run.
+EffectStats getLastEffectStats() {
+  return lastEffectStats;
+}
+
+/// @brief Prints effect statistics on one line, e.g. to `Serial`. Only available when `SSD1306FUNC_STATS` is `1`.
+/// @param out Where to print, e.g. `Serial`.
+/// @param stats The statistics to print, from `getLastEffectStats()` or `getStats()`.
+void printEffectStats(Print& out, EffectStats stats) {
+  out.print(F("frames="));
+  out.print(stats.frames);
+  out.print(F(" merged="));
+  out.print(stats.mergedFrames);
+  out.print(F(" draw="));
+  out.print(stats.drawMicros);
+  out.print(F("us flush="));
+  out.print(stats.flushMicros);
+  out.print(F("us bytes="));
+  out.print(stats.bytes);
+  out.print(F(" requested="));
+  out.print(stats.requestedMillis);
+  out.print(F("ms actual="));
+  out.print(stats.actualMillis);
+  out.println(F("ms"));
+}
+
+/// @brief Estimates how long sending `bytes` takes on a bus, e.g. to see what an effect measured on one bus would cost on another. Only available when `SSD1306FUNC_STATS` is `1`.
+/// @param bytes Command and data bytes, as counted in `EffectStats::bytes`.
+/// @param hz The bus clock, e.g. `400000` for fast-mode I2C.
+/// @param spi If `true`, an SPI bus: 8 clocks per byte. Otherwise I2C: 9 clocks per byte, plus the start, address, control byte and stop of each transaction.
+/// @return The time in microseconds, not counting the CPU time between transfers.
+unsigned long estimateBusMicros(unsigned long bytes, uint32_t hz, bool spi) {
+  if (!hz) return 0;
+
+  float clocks = bytes * 8.0f;
+  if (!spi) {
+    unsigned long transactions = (bytes + WIRE_MAX - 2) / (WIRE_MAX - 1);
+    clocks = (bytes + 2 * transactions) * 9.0f + transactions * 2;
+  }
+  return clocks * 1000000.0f / hz;
+}
+
+/// @brief Prints the bytes per frame of an effect and the time its flushes take on common buses, e.g. to `Serial`. Only available when `SSD1306FUNC_STATS` is `1`.
+/// @param out Where to print, e.g. `Serial`.
+/// @param stats The statistics to print, from `getLastEffectStats()` or `getStats()`.
+void printBusEstimates(Print& out, EffectStats stats) {
+  static const uint32_t clocks[] = {100000, 400000, 1000000, 8000000};
+
+  out.print(F("bytes/frame="));
+  out.print(stats.frames ? stats.bytes / stats.frames : 0);
+  for (uint8_t i = 0; i < 4; i++) {
+    out.print(i < 3 ? F(" i2c@") : F(" spi@"));
+    out.print(clocks[i] / 1000);
+    out.print(F("kHz="));
+    out.print(estimateBusMicros(stats.bytes, clocks[i], i == 3));
+    out.print(F("us"));
+  }
+  out.println();
+}
+#endif
+
+/// @brief Runs an effect to completion, blocking until its last frame has been shown.
+/// @param effect The effect to run. Its `begin()` must have been called beforehand.
+void runEffect(SSD1306Effect& effect) {
+  while (effect.tick(millis())) effect.idle();
+}
+
+/// @brief Gets the display the effect draws on.
+/// @return The display passed to `begin()`, or `NULL` before the first `begin()`.
+Adafruit_SSD1306* SSD1306Effect::getDisplay() {
+  return display;
+}
+
+enum { GROUP_ALL, GROUP_ON_BUS, GROUP_OFF_BUS };
+
+// Ticks the effects of one group until all of them are done, sleeping only while none of them is sending.
+static void runEffectGroup(SSD1306Effect** effects, uint8_t count, const void* bus, uint8_t group) {
+  for (;;) {
+    bool running = false;
+#if SSD1306FUNC_SLEEP
+    bool sending = false;
+#endif
+
+    for (uint8_t i = 0; i < count; i++) {
+      Adafruit_SSD1306* display = effects[i]->getDisplay();
+      if (group != GROUP_ALL && (getBus(display) == bus) != (group == GROUP_ON_BUS)) continue;
+      if (!effects[i]->tick(millis())) continue;
+
+      running = true;
+#if SSD1306FUNC_SLEEP
+      if (isSending(display)) sending = true;
+#endif
+    }
+
+    if (!running) return;
+#if SSD1306FUNC_SLEEP
+    if (!sending) {
+      sleepUntilInterrupt();
+      continue;
+    }
+#endif
+    yield();
+  }
+}
+
+#if SSD1306FUNC_DUAL_CORE
+typedef struct EffectGroupTask {
+  SSD1306Effect** effects;
+  uint8_t count;
+  const void* bus;
+  SemaphoreHandle_t done;
+} EffectGroupTask;
+
+static void runEffectGroupTask(void* parameter) {
+  EffectGroupTask* task = (EffectGroupTask*) parameter;
+  runEffectGroup(task->effects, task->count, task->bus, GROUP_OFF_BUS);
+  xSemaphoreGive(task->done);
+  vTaskDelete(NULL);
+}
+#endif
+
+/// @brief Runs several effects at the same time, e.g. on different displays, blocking until all of them are done. Frames are drawn as each effect's deadlines come up, so the whole run takes about as long as the slowest effect. With `SSD1306FUNC_ASYNC_FLUSH`, the displays' transfers are interleaved chunk by chunk; with `SSD1306FUNC_DUAL_CORE`, effects on another bus than the first effect's run on the other core.
+/// @param effects The effects to run. Each one's `begin()` must have been called beforehand, and no two may draw on the same display.
+/// @param count Number of effects.
+void runEffects(SSD1306Effect** effects, uint8_t count) {
+  // Claim every display's tracking slot up front, so nothing is allocated once the effects run side by side
+  for (uint8_t i = 0; i < count; i++) getDisplayState(effects[i]->getDisplay());
+
+#if SSD1306FUNC_DUAL_CORE
+  const void* bus = count ? getBus(effects[0]->getDisplay()) : NULL;
+  bool otherbus = false;
+  for (uint8_t i = 1; i < count; i++) {
+    if (getBus(effects[i]->getDisplay()) != bus) otherbus = true;
+  }
+
+  if (otherbus) {
+    EffectGroupTask task = {effects, count, bus, xSemaphoreCreateBinary()};
+    if (task.done && xTaskCreatePinnedToCore(runEffectGroupTask, "SSD1306Func", SSD1306FUNC_TASK_STACK, &task, uxTaskPriorityGet(NULL), NULL, 1 - xPortGetCoreID()) == pdPASS) {
+      runEffectGroup(effects, count, bus, GROUP_ON_BUS);
+      xSemaphoreTake(task.done, portMAX_DELAY);
+      vSemaphoreDelete(task.done);
+      return;
+    }
+    if (task.done) vSemaphoreDelete(task.done);
+  }
+#endif
+
+  runEffectGroup(effects, count, NULL, GROUP_ALL);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// FADE WHITEOUT/BLACKOUT FUNCTIONS
+
+// Built-in tile patterns. `fadeGrid` covers even columns, then even rows, then odd columns; `fadeInGridBitmap` clears the
+// white screen with even columns, even rows, then odd rows; `fadeDissolve` covers an 8x8 ordered-dither matrix in eight steps.
+static const uint8_t gridTiles[] PROGMEM = {
+  0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00,
+  0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+  0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF,
+};
+
+static const uint8_t unveilTiles[] PROGMEM = {
+  0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00,
+  0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+  0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA,
+};
+
+static const uint8_t dissolveTiles[] PROGMEM = {
+  0x11, 0x00, 0x44, 0x00, 0x11, 0x00, 0x44, 0x00,
+  0x44, 0x00, 0x11, 0x00, 0x44, 0x00, 0x11, 0x00,
+  0x00, 0x22, 0x00, 0x88, 0x00, 0x22, 0x00, 0x88,
+  0x00, 0x88, 0x00, 0x22, 0x00, 0x88, 0x00, 0x22,
+  0x00, 0x11, 0x00, 0x44, 0x00, 0x11, 0x00, 0x44,
+  0x00, 0x44, 0x00, 0x11, 0x00, 0x44, 0x00, 0x11,
+  0x22, 0x00, 0x88, 0x00, 0x22, 0x00, 0x88, 0x00,
+  0x88, 0x00, 0x22, 0x00, 0x88, 0x00, 0x22, 0x00,
+};
+
+static const FadeMask gridMask = {gridTiles, 3, 0, 0};
+static const FadeMask unveilMask = {unveilTiles, 3, 0, 0};
+static const FadeMask dissolveMask = {dissolveTiles, 8, 0, 0};
+
+static inline void maskByte(uint8_t* dest, uint8_t bits, uint16_t color) {
+  if (color) *dest |= bits;
+  else *dest &= ~bits;
+}
+
+// Turns the pixels of step `step` of `mask` on (`color` 1) or off (`color` 0) in pages `firstpage` to `lastpage` of the screen,
+// which `buffer` holds from `firstpage` on. Masks are given in screen coordinates, so they are mapped back through the rotation
+// onto the unrotated page layout.
+static void maskPages(Adafruit_SSD1306* display, uint8_t* buffer, int16_t firstpage, int16_t lastpage, const FadeMask& mask, uint16_t step, uint16_t color) {
+  uint8_t rotation = display->getRotation();
+  int16_t columns = getPanelWidth(display);
+  int16_t rows = getPanelHeight(display);
+
+  if (mask.tiles) {
+    const uint8_t* src = mask.tiles + step * 8;
+    uint8_t tile[8];
+
+    if (!rotation) memcpy_P(tile, src, 8);
+    else {
+      memset(tile, 0, 8);
+      for (uint8_t i = 0; i < 8; i++) {
+        for (uint8_t j = 0; j < 8; j++) {
+          uint8_t x = rotation == 1 ? j : rotation == 2 ? 7 - i : 7 - j;
+          uint8_t y = rotation == 1 ? 7 - i : rotation == 2 ? 7 - j : i;
+          if (pgm_read_byte(src + x) & (1 << y)) tile[i] |= 1 << j;
+        }
+      }
+    }
+
+    for (int16_t page = firstpage; page <= lastpage; page++) {
+      uint8_t* dest = buffer + (page - firstpage) * columns;
+      for (int16_t col = 0; col < columns; col++) maskByte(dest + col, tile[col & 7], color);
+    }
+    return;
+  }
+
+  // Line pattern: the value dx * x + dy * y, rewritten in unrotated coordinates as ax * column + ay * row + offset
+  int16_t period = mask.steps;
+  int16_t ax, ay;
+  int32_t offset;
+  if (rotation == 1) { ax = -mask.dy; ay = mask.dx; offset = (int32_t) mask.dy * (columns - 1); }
+  else if (rotation == 2) { ax = -mask.dx; ay = -mask.dy; offset = (int32_t) mask.dx * (columns - 1) + (int32_t) mask.dy * (rows - 1); }
+  else if (rotation == 3) { ax = mask.dy; ay = -mask.dx; offset = (int32_t) mask.dx * (rows - 1); }
+  else { ax = mask.dx; ay = mask.dy; offset = 0; }
+
+  // Every `period`th bit of a page byte, from bit 0
+  uint8_t spread = 0;
+  for (int16_t b = 0; b < 8; b += period) spread |= 1 << b;
+
+  int16_t colstep = ((ax % period) + period) % period;
+  if (ay > 0) colstep = (period - colstep) % period;
+
+  for (int16_t page = firstpage; page <= lastpage; page++) {
+    uint8_t* dest = buffer + (page - firstpage) * columns;
+    int16_t value = (((offset + (int32_t) ay * page * 8) % period) + period) % period;
+
+    // `first` is the lowest bit of the byte that belongs to `step`; with ay == 0 a column is either fully in or out
+    int16_t first = ay > 0 ? (step - value + period) % period : ay < 0 ? (value - step + period) % period : value;
+    for (int16_t col = 0; col < columns; col++) {
+      uint8_t bits;
+      if (ay) bits = first < 8 ? (uint8_t) (spread << first) : 0;
+      else bits = first == (int16_t) step ? 0xFF : 0x00;
+      maskByte(dest + col, bits, color);
+
+      first += colstep;
+      if (first >= period) first -= period;
+    }
+  }
+}
+
+// Applies a mask step to the whole framebuffer in a single pass.
+static void applyMask(Adafruit_SSD1306* display, const FadeMask& mask, uint16_t step, uint16_t color) {
+  maskPages(display, display->getBuffer(), 0, (getPanelHeight(display) + 7) / 8 - 1, mask, step, color);
+}
+
+// Shared by every fade: one frame per step of `mask`, then a cleared screen for fade-outs.
+void FadeEffect::startFade(Adafruit_SSD1306* display, FadeMask mask, long stepdelay, uint16_t state) {
+  this->mask = mask;
+  this->stepdelay = stepdelay;
+  this->state = state;
+  start(display);
+}
+
+long FadeEffect::step() {
+  if (frame < mask.steps) {
+    applyMask(display, mask, frame, state);
+    markDirty(display, 0, 0, display->width(), display->height());
+    return stepdelay;
+  }
+
+  if (frame == mask.steps && !state) {
+    display->clearDisplay();
+    markDirty(display, 0, 0, display->width(), display->height());
+    return stepdelay;
+  }
+
+  return EFFECT_DONE;
+}
+
+/// @brief Starts a non-blocking `fadeGrid`. Call `tick()` until it returns `false`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param delaytime Number of milliseconds taken per step. Using negative values will use the recommended value (`50`).
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void FadeGridEffect::begin(Adafruit_SSD1306* display, long delaytime, uint16_t state) {
+  if (delaytime < 0) delaytime = 50;   // Recommended delay time
+  startFade(display, gridMask, delaytime, state);
+}
+
+/// @brief Starts a non-blocking `fadeCross`. Call `tick()` until it returns `false`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param delaytime Number of milliseconds taken per step. Using negative values will use the recommended value (`50`).
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void FadeCrossEffect::begin(Adafruit_SSD1306* display, long delaytime, uint16_t state) {
+  if (delaytime < 0) delaytime = 50;
+  FadeMask cross = {NULL, 2, 1, 1};
+  startFade(display, cross, delaytime, state);
+}
+
+/// @brief Starts a non-blocking `fadeVertical`. Call `tick()` until it returns `false`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param cycles Number of steps for the fade. Using negative values will use the recommended value (`4`).
+/// @param wholedelaytime The duration of the entire fade transition. Using negative values will use the recommended value.
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void FadeVerticalEffect::begin(Adafruit_SSD1306* display, int cycles, long wholedelaytime, uint16_t state) {
+  // Recommended values
+  if (cycles < 0) cycles = 4;
+  if (wholedelaytime < 0) wholedelaytime = 10 * cycles;
+
+  FadeMask blinds = {NULL, (uint16_t) cycles, 1, 0};
+  startFade(display, blinds, cycles ? wholedelaytime / cycles : 0, state);
+}
+
+/// @brief Starts a non-blocking `fadeHorizontal`. Call `tick()` until it returns `false`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param cycles Number of steps for the fade. Using negative values will use the recommended value (`3`).
+/// @param wholedelaytime The duration of the entire fade transition. Using negative values will use the recommended value.
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void FadeHorizontalEffect::begin(Adafruit_SSD1306* display, int cycles, long wholedelaytime, uint16_t state) {
+  // Recommended values
+  if (cycles < 0) cycles = 3;
+  if (wholedelaytime < 0) wholedelaytime = 10 * cycles;
+
+  FadeMask blinds = {NULL, (uint16_t) cycles, 0, 1};
+  startFade(display, blinds, cycles ? wholedelaytime / cycles : 0, state);
+}
+
+/// @brief Starts a non-blocking `fadeDiagonal`. Call `tick()` until it returns `false`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param cycles Number of steps for the fade. Using negative values will use the recommended value (`4`).
+/// @param wholedelaytime The duration of the entire fade transition. Using negative values will use the recommended value.
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void FadeDiagonalEffect::begin(Adafruit_SSD1306* display, int cycles, long wholedelaytime, uint16_t state) {
+  // Recommended values
+  if (cycles < 0) cycles = 4;
+  if (wholedelaytime < 0) wholedelaytime = 25 * cycles;
+
+  FadeMask diagonals = {NULL, (uint16_t) cycles, 1, 1};
+  startFade(display, diagonals, cycles ? wholedelaytime / cycles : 0, state);
+}
+
+/// @brief Starts a non-blocking `fadeDissolve`. Call `tick()` until it returns `false`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param delaytime Number of milliseconds taken per step. Using negative values will use the recommended value (`40`).
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void FadeDissolveEffect::begin(Adafruit_SSD1306* display, long delaytime, uint16_t state) {
+  if (delaytime < 0) delaytime = 40;
+  startFade(display, dissolveMask, delaytime, state);
+}
+
+/// @brief Starts a non-blocking `fadeMask`. Call `tick()` until it returns `false`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param mask The pattern covered by each step. Tiles have to stay in PROGMEM while the fade runs.
+/// @param delaytime Number of milliseconds taken per step. Using negative values will use the recommended value (`50`).
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void MaskFadeEffect::begin(Adafruit_SSD1306* display, FadeMask mask, long delaytime, uint16_t state) {
+  if (delaytime < 0) delaytime = 50;
+  startFade(display, mask, delaytime, state);
+}
+
+/// @brief A checkerboard-style fade transition. Fades in three steps, to either full black or full white/on.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param delaytime Number of milliseconds taken per step. Using negative values will use the recommended value (`50`).
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void fadeGrid(Adafruit_SSD1306* display, long delaytime, uint16_t state) {
+  FadeGridEffect effect;
+  effect.begin(display, delaytime, state);
+  runEffect(effect);
+}
+
+/// @brief A diagonal version of the grid fade transition. Fades in two steps, to either full black or full white/on.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param delaytime Number of milliseconds taken per step. Using negative values will use the recommended value (`50`).
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void fadeCross(Adafruit_SSD1306* display, long delaytime, uint16_t state) {
+  FadeCrossEffect effect;
+  effect.begin(display, delaytime, state);
+  runEffect(effect);
+}
+
+/// @brief A fade transition resembling vertical blinds. Fades to either full black or full white/on.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param cycles Number of steps for the fade. Using negative values will use the recommended value (`4`).
+/// @param wholedelaytime The duration of the entire fade transition. Using negative values will use the recommended value.
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void fadeVertical(Adafruit_SSD1306* display, int cycles, long wholedelaytime, uint16_t state) {
+  FadeVerticalEffect effect;
+  effect.begin(display, cycles, wholedelaytime, state);
+  runEffect(effect);
+}
+
+/// @brief A fade transition resembling horizontal blinds. Fades to either full black or full white/on.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param cycles Number of steps for the fade. Using negative values will use the recommended value (`3`).
+/// @param wholedelaytime The duration of the entire fade transition. Using negative values will use the recommended value.
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void fadeHorizontal(Adafruit_SSD1306* display, int cycles, long wholedelaytime, uint16_t state) {
+  FadeHorizontalEffect effect;
+  effect.begin(display, cycles, wholedelaytime, state);
+  runEffect(effect);
+}
+
+/// @brief A fade transition using diagonal lines. Fades to either full black or full white/on.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param cycles Number of steps for the fade. Using negative values will use the recommended value (`4`).
+/// @param wholedelaytime The duration of the entire fade transition. Using negative values will use the recommended value.
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void fadeDiagonal(Adafruit_SSD1306* display, int cycles, long wholedelaytime, uint16_t state) {
+  FadeDiagonalEffect effect;
+  effect.begin(display, cycles, wholedelaytime, state);
+  runEffect(effect);
+}
+
+/// @brief An ordered-dither dissolve. Fades in eight steps, to either full black or full white/on.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param delaytime Number of milliseconds taken per step. Using negative values will use the recommended value (`40`).
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void fadeDissolve(Adafruit_SSD1306* display, long delaytime, uint16_t state) {
+  FadeDissolveEffect effect;
+  effect.begin(display, delaytime, state);
+  runEffect(effect);
+}
+
+/// @brief A fade transition following a custom `FadeMask`, one framebuffer pass per step. Fades to either full black or full white/on.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param mask The pattern covered by each step. Later steps may cover pixels again, but every pixel should be covered by some step.
+/// @param delaytime Number of milliseconds taken per step. Using negative values will use the recommended value (`50`).
+/// @param state Either `0` or `1`. Use `0` for a fade-out, while `1` for fade-in.
+void fadeMask(Adafruit_SSD1306* display, FadeMask mask, long delaytime, uint16_t state) {
+  MaskFadeEffect effect;
+  effect.begin(display, mask, delaytime, state);
+  runEffect(effect);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// IMAGE PROCESSING FUNCTIONS
+
+// Transposes an 8x8 block of a row-major bitmap. `rows[i]` holds row i with its leftmost pixel in bit 7; on return,
+// `cols[j]` holds column j with its top pixel in bit 0, which is the vertical byte layout of the SSD1306 pages.
+static void transposeBlock(const uint8_t* rows, uint8_t* cols) {
+  memset(cols, 0, 8);
+
+  for (uint8_t i = 0; i < 8; i++) {
+    uint8_t row = rows[i];
+    uint8_t bit = 1 << i;
+    for (uint8_t j = 0; row; j++, row <<= 1) {
+      if (row & 0x80) cols[j] |= bit;
+    }
+  }
+}
+
+static inline void applyByte(uint8_t* dest, uint8_t bits, uint16_t color) {
+  if (color == SSD1306_WHITE) *dest |= bits;
+  else if (color == SSD1306_BLACK) *dest &= ~bits;
+  else *dest ^= bits;
+}
+
+ImageSource::ImageSource(int width, int height) : width(width), height(height) {}
+
+const uint8_t* ImageSource::getPages() {
+  return NULL;
+}
+
+ProgmemImageSource::ProgmemImageSource(const uint8_t* bitmap, int width, int height) : ImageSource(width, height), bitmap(bitmap) {}
+
+ProgmemImageSource::ProgmemImageSource(Image bmp) : ImageSource(bmp.width, bmp.height), bitmap(bmp.bitmap) {}
+
+void ProgmemImageSource::read(int16_t row, uint8_t count, int16_t firstbyte, uint8_t bytes, uint8_t* dest) {
+  uint16_t bytewidth = (width + 7) / 8;
+  for (uint8_t i = 0; i < count; i++) memcpy_P(dest + i * bytes, bitmap + (uint32_t) (row + i) * bytewidth + firstbyte, bytes);
+}
+
+RamImageSource::RamImageSource(const uint8_t* bitmap, int width, int height) : ImageSource(width, height), bitmap(bitmap) {}
+
+void RamImageSource::read(int16_t row, uint8_t count, int16_t firstbyte, uint8_t bytes, uint8_t* dest) {
+  uint16_t bytewidth = (width + 7) / 8;
+  for (uint8_t i = 0; i < count; i++) memcpy(dest + i * bytes, bitmap + (uint32_t) (row + i) * bytewidth + firstbyte, bytes);
+}
+
+StreamImageSource::StreamImageSource(ImageReader reader, void* context, int width, int height, uint32_t offset)
+  : ImageSource(width, height), reader(reader), context(context), offset(offset) {}
+
+void StreamImageSource::read(int16_t row, uint8_t count, int16_t firstbyte, uint8_t bytes, uint8_t* dest) {
+  uint16_t bytewidth = (width + 7) / 8;
+  uint32_t start = offset + (uint32_t) row * bytewidth + firstbyte;
+
+  // Whole rows are contiguous, so they can be read in one go
+  if (bytes == bytewidth) reader(context, start, dest, count * bytes);
+  else for (uint8_t i = 0; i < count; i++) reader(context, start + (uint32_t) i * bytewidth, dest + i * bytes, bytes);
+}
+
+// Position in a stream of PackBits runs: a control byte below `0x80` is followed by that many plus one literal bytes, any
+// other by one byte repeated `control - 0x7E` times.
+typedef struct RleCursor {
+  const uint8_t* pos;               // Next control or data byte, in PROGMEM.
+  uint8_t left;                     // Bytes left in the current run.
+  bool repeat;                      // Whether the current run repeats `value`, rather than copying literal bytes.
+  uint8_t value;
+} RleCursor;
+
+static uint8_t nextRleByte(RleCursor* cursor) {
+  if (!cursor->left) {
+    uint8_t control = pgm_read_byte(cursor->pos++);
+    cursor->repeat = control & 0x80;
+    cursor->left = cursor->repeat ? control - 0x7E : control + 1;
+    if (cursor->repeat) cursor->value = pgm_read_byte(cursor->pos++);
+  }
+
+  cursor->left--;
+  return cursor->repeat ? cursor->value : pgm_read_byte(cursor->pos++);
+}
+
+// Skips `count` decoded bytes a whole run at a time.
+static void skipRleBytes(RleCursor* cursor, uint16_t count) {
+  while (count) {
+    if (!cursor->left) {
+      nextRleByte(cursor);
+      count--;
+      continue;
+    }
+
+    uint8_t skip = count < cursor->left ? count : cursor->left;
+    if (!cursor->repeat) cursor->pos += skip;
+    cursor->left -= skip;
+    count -= skip;
+  }
+}
+
+RleImageSource::RleImageSource(const uint8_t* data, int width, int height) : ImageSource(width, height), data(data) {}
+
+void RleImageSource::read(int16_t row, uint8_t count, int16_t firstbyte, uint8_t bytes, uint8_t* dest) {
+  uint16_t bands = (height + 7) / 8;
+
+  // Each band is decoded from its offset up to the last byte column asked for
+  while (count) {
+    uint16_t band = row / 8;
+    uint8_t first = row & 7;
+    uint8_t rows = 8 - first < count ? 8 - first : count;
+
+    RleCursor cursor = {data + bands * 2 + (pgm_read_byte(data + band * 2) | pgm_read_byte(data + band * 2 + 1) << 8), 0, false, 0};
+    skipRleBytes(&cursor, firstbyte * 8 + first);
+    for (uint8_t b = 0; b < bytes; b++) {
+      for (uint8_t i = 0; i < rows; i++) dest[i * bytes + b] = nextRleByte(&cursor);
+      if (b + 1 < bytes) skipRleBytes(&cursor, 8 - rows);
+    }
+
+    row += rows;
+    count -= rows;
+    dest += rows * bytes;
+  }
+}
+
+TileImageSource::TileImageSource(const uint8_t* data, int width, int height) : ImageSource(width, height), data(data) {}
+
+void TileImageSource::read(int16_t row, uint8_t count, int16_t firstbyte, uint8_t bytes, uint8_t* dest) {
+  uint16_t bytewidth = (width + 7) / 8;
+  const uint8_t* tiles = data + (uint32_t) ((height + 7) / 8) * bytewidth;
+
+  for (uint8_t i = 0; i < count; i++) {
+    int16_t r = row + i;
+    const uint8_t* cells = data + (uint32_t) (r / 8) * bytewidth + firstbyte;
+    for (uint8_t j = 0; j < bytes; j++) dest[i * bytes + j] = pgm_read_byte(tiles + pgm_read_byte(cells + j) * 8 + (r & 7));
+  }
+}
+
+PageImageSource::PageImageSource(const uint8_t* data, int width, int height) : ImageSource(width, height), data(data) {}
+
+// Rows are gathered from the page bytes a bit at a time, for the draws that need rows: rotated screens, mostly.
+void PageImageSource::read(int16_t row, uint8_t count, int16_t firstbyte, uint8_t bytes, uint8_t* dest) {
+  for (uint8_t i = 0; i < count; i++) {
+    int16_t r = row + i;
+    const uint8_t* page = data + (uint32_t) (r / 8) * width;
+    uint8_t bit = 1 << (r & 7);
+
+    for (uint8_t j = 0; j < bytes; j++) {
+      int16_t x = (firstbyte + j) * 8;
+      uint8_t value = 0;
+      for (uint8_t k = 0; k < 8; k++) {
+        if (x + k < width && (pgm_read_byte(page + x + k) & bit)) value |= 0x80 >> k;
+      }
+      dest[i * bytes + j] = value;
+    }
+  }
+}
+
+const uint8_t* PageImageSource::getPages() {
+  return data;
+}
+
+// Most source bytes a clipped row can span: a full row of pixels starting mid-byte, e.g. 17 bytes for 128 columns.
+#define BAND_BYTES (SSD1306FUNC_MAX_COLUMNS / 8 + 1)
+
+// Draws `source` into pages `firstpage` to `lastpage` of an unrotated screen, which `buffer` holds from `firstpage` on, and
+// only into columns `startcol` to `endcol` (exclusive).
+static void blitPages(Adafruit_SSD1306* display, uint8_t* buffer, int16_t firstpage, int16_t lastpage, int16_t startcol, int16_t endcol, int16_t x, int16_t y, ImageSource* source, uint16_t color) {
+  int16_t width = source->width;
+  int16_t height = source->height;
+  int16_t screenwidth = display->width();
+  int16_t bytewidth = (width + 7) / 8;
+
+  // Bitmaps stored in the page layout are copied a column byte at a time: onto one page, or split over two when `y` is not
+  // page-aligned
+  const uint8_t* pagedata = source->getPages();
+  if (pagedata) {
+    int16_t firstcol = startcol > x ? startcol : x;
+    int16_t stopcol = endcol < x + width ? endcol : x + width;
+    int16_t top = y >= 0 ? y / 8 : -((7 - y) / 8);
+    uint8_t shift = y - top * 8;
+    int16_t first = firstpage - top - 1 > 0 ? firstpage - top - 1 : 0;
+    int16_t last = lastpage - top < (height + 7) / 8 - 1 ? lastpage - top : (height + 7) / 8 - 1;
+
+    for (int16_t srcpage = first; srcpage <= last && firstcol < stopcol; srcpage++) {
+      int16_t page = top + srcpage;
+      bool upper = page >= firstpage && page <= lastpage;
+      bool lower = shift && page + 1 >= firstpage && page + 1 <= lastpage;
+      const uint8_t* src = pagedata + (uint32_t) srcpage * width + (firstcol - x);
+
+      for (int16_t col = firstcol; col < stopcol; col++) {
+        uint8_t bits = pgm_read_byte(src++);
+        if (!bits) continue;
+        if (upper) applyByte(buffer + (page - firstpage) * screenwidth + col, bits << shift, color);
+        if (lower) applyByte(buffer + (page + 1 - firstpage) * screenwidth + col, bits >> (8 - shift), color);
+      }
+    }
+    return;
+  }
+
+  // Only the source rows and bytes that land on these pages and columns are read
+  int16_t firstrow = firstpage * 8 - y > 0 ? firstpage * 8 - y : 0;
+  int16_t lastrow = (lastpage + 1) * 8 - y < height ? (lastpage + 1) * 8 - y : height;
+  int16_t firstbyte = startcol - x > 0 ? (startcol - x) / 8 : 0;
+  int16_t lastbyte = (endcol - x + 7) / 8 < bytewidth ? (endcol - x + 7) / 8 : bytewidth;
+  if (firstrow >= lastrow || firstbyte >= lastbyte) return;
+  uint8_t bytes = lastbyte - firstbyte;
+
+  uint8_t band[8 * BAND_BYTES];
+  uint8_t rows[8];
+  uint8_t cols[8];
+
+  for (int16_t bandrow = firstrow & ~7; bandrow < lastrow; bandrow += 8) {
+    int16_t page = (y + bandrow) >> 3;
+    uint8_t shift = (y + bandrow) & 7;
+    int16_t from = bandrow > firstrow ? bandrow : firstrow;
+    int16_t to = bandrow + 8 < lastrow ? bandrow + 8 : lastrow;
+
+    memset(band, 0, sizeof(band));
+    source->read(from, to - from, firstbyte, bytes, band + (from - bandrow) * bytes);
+
+    for (uint8_t b = 0; b < bytes; b++) {
+      for (uint8_t i = 0; i < 8; i++) rows[i] = band[i * bytes + b];
+      transposeBlock(rows, cols);
+
+      int16_t left = (firstbyte + b) * 8;
+      for (uint8_t j = 0; j < 8 && left + j < width; j++) {
+        int16_t col = x + left + j;
+        if (!cols[j] || col < startcol || col >= endcol) continue;
+
+        if (page >= firstpage && page <= lastpage) applyByte(buffer + (page - firstpage) * screenwidth + col, cols[j] << shift, color);
+        if (shift && page + 1 >= firstpage && page + 1 <= lastpage) applyByte(buffer + (page + 1 - firstpage) * screenwidth + col, cols[j] >> (8 - shift), color);
+      }
+    }
+  }
+}
+
+static void blitBitmap(Adafruit_SSD1306* display, int16_t x, int16_t y, ImageSource* source, uint16_t color) {
+  int16_t width = source->width;
+  int16_t height = source->height;
+  int16_t screenwidth = display->width();
+  int16_t pages = (display->height() + 7) / 8;
+  int16_t bytewidth = (width + 7) / 8;
+
+  // The page layout assumes an unrotated screen; rotated ones draw row by row
+  if (!display->getRotation()) {
+    blitPages(display, display->getBuffer(), 0, pages - 1, 0, screenwidth, x, y, source, color);
+    return;
+  }
+
+  // Only the source rows and bytes that land on the screen are read
+  int16_t firstrow = y < 0 ? -y : 0;
+  int16_t lastrow = pages * 8 - y < height ? pages * 8 - y : height;
+  int16_t firstbyte = x < 0 ? -x / 8 : 0;
+  int16_t lastbyte = (screenwidth - x + 7) / 8 < bytewidth ? (screenwidth - x + 7) / 8 : bytewidth;
+  if (firstrow >= lastrow || firstbyte >= lastbyte) return;
+  uint8_t bytes = lastbyte - firstbyte;
+
+  uint8_t line[BAND_BYTES];
+  int16_t linewidth = bytes * 8 < width - firstbyte * 8 ? bytes * 8 : width - firstbyte * 8;
+  for (int16_t row = firstrow; row < lastrow; row++) {
+    source->read(row, 1, firstbyte, bytes, line);
+    display->drawBitmap(x + firstbyte * 8, y + row, line, linewidth, 1, color);
+  }
+}
+
+// The bits of `page` that rows `top` to `bottom` (exclusive) cover.
+static inline uint8_t rowBits(int16_t page, int16_t top, int16_t bottom) {
+  int16_t lo = top - page * 8;
+  int16_t hi = bottom - page * 8;
+  if (lo < 0) lo = 0;
+  if (hi > 8) hi = 8;
+  return lo < hi ? (uint8_t) ((0xFF << lo) & (0xFF >> (8 - hi))) : 0;
+}
+
+// Moves rows `top` to `bottom` (exclusive) of framebuffer columns `startcol` to `endcol` (exclusive) down by `delta` rows, or up
+// when it is negative, a page byte at a time with the bits carried across pages. Of those rows, the ones from `srctop` to
+// `srcbottom` get the row `delta` away from them, and the others are cleared; rows outside the range are left alone.
+static void shiftColumns(Adafruit_SSD1306* display, int16_t startcol, int16_t endcol, int16_t top, int16_t bottom, int16_t srctop, int16_t srcbottom, int16_t delta) {
+  uint8_t* buffer = display->getBuffer();
+  int16_t width = display->width();
+  int16_t pages = (display->height() + 7) / 8;
+  int16_t firstpage = top >> 3;
+  int16_t lastpage = (bottom - 1) >> 3;
+
+  // Moving down reads the pages above, so pages are done bottom up; moving up, top down
+  for (int16_t n = 0; n <= lastpage - firstpage; n++) {
+    int16_t page = delta > 0 ? lastpage - n : firstpage + n;
+    uint8_t region = rowBits(page, top, bottom);
+    uint8_t valid = region & rowBits(page, srctop, srcbottom);
+
+    // Source rows start at `from`, which is bit `shift` of page `high`
+    int16_t from = page * 8 - delta;
+    int16_t high = from >= 0 ? from / 8 : -((7 - from) / 8);
+    uint8_t shift = from - high * 8;
+    const uint8_t* upper = high >= 0 && high < pages ? buffer + high * width : NULL;
+    const uint8_t* lower = shift && high + 1 >= 0 && high + 1 < pages ? buffer + (high + 1) * width : NULL;
+
+    uint8_t* dest = buffer + page * width;
+    for (int16_t col = startcol; col < endcol; col++) {
+      uint8_t bits = 0;
+      if (upper) bits = upper[col] >> shift;
+      if (lower) bits |= lower[col] << (8 - shift);
+      dest[col] = (dest[col] & ~region) | (bits & valid);
+    }
+  }
+}
+
+/// @brief Draws an `Image` straight into the framebuffer, 8x8 pixels at a time. Same result as `drawBitmap`: set bits are drawn in `color`, cleared bits are left alone.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param x The x-coordinate of the image, starting at top-left.
+/// @param y The y-coordinate of the image, starting at top-left. Rows that do not start on a page boundary are split over two pages.
+/// @param bmp The bitmap to be drawn.
+/// @param color Either `0` (off), `1` (on), or `2` (inverse).
+void blitImage(Adafruit_SSD1306* display, int16_t x, int16_t y, Image bmp, uint16_t color) {
+  ProgmemImageSource source(bmp);
+  blitBitmap(display, x, y, &source, color);
+}
+
+/// @brief Same as the `Image` version of `blitImage`, reading only the rows and bytes that land on the screen from `source`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param x The x-coordinate of the image, starting at top-left.
+/// @param y The y-coordinate of the image, starting at top-left.
+/// @param source Where the bitmap rows are read from.
+/// @param color Either `0` (off), `1` (on), or `2` (inverse).
+void blitImage(Adafruit_SSD1306* display, int16_t x, int16_t y, ImageSource& source, uint16_t color) {
+  blitBitmap(display, x, y, &source, color);
+}
+
+/// @brief Starts a non-blocking `fadeInGridBitmap`. Call `tick()` until it returns `false`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param delaytime Number of milliseconds taken per step in the 3-step initial fade. Using negative values will use the recommended value (`50`).
+/// @param initdelaytime Number of milliseconds to wait after the initial fade before drawing the bitmap. Using negative values will use the recommended value (`500`).
+/// @param offset_x The x-coordinate of the image, starting at top-left.
+/// @param offset_y The y-coordinate of the image, starting at top-left.
+/// @param bmp The bitmap to be drawn.
+void FadeInGridBitmapEffect::begin(Adafruit_SSD1306* display, long delaytime, long initdelaytime, int16_t offset_x, int16_t offset_y, Image bmp) {
+  image = ProgmemImageSource(bmp);
+  begin(display, delaytime, initdelaytime, offset_x, offset_y, image);
+}
+
+/// @brief Starts a non-blocking `fadeInGridBitmap` that reads its rows from `source`, which has to outlive the effect.
+void FadeInGridBitmapEffect::begin(Adafruit_SSD1306* display, long delaytime, long initdelaytime, int16_t offset_x, int16_t offset_y, ImageSource& source) {
+  // Recommended values
+  if (delaytime < 0) delaytime = 50;
+  if (initdelaytime < 0) initdelaytime = 500;
+
+  this->delaytime = delaytime;
+  this->initdelaytime = initdelaytime;
+  this->offset_x = offset_x;
+  this->offset_y = offset_y;
+  this->source = &source;
+  start(display);
+}
+
+long FadeInGridBitmapEffect::step() {
+  // Frames 0-2: the `fadeGrid` fade-in, holding the white screen for `initdelaytime` after the last step
+  if (frame < 3) {
+    applyMask(display, gridMask, frame, ON);
+    markDirty(display, 0, 0, display->width(), display->height());
+    return frame == 2 ? delaytime + initdelaytime : delaytime;
+  }
+
+  // Frames 3-5: clear the white screen in three interlaced passes, redrawing the bitmap over each
+  if (frame >= 6) return EFFECT_DONE;
+
+  applyMask(display, unveilMask, frame - 3, OFF);
+  blitBitmap(display, offset_x, offset_y, source, ON);
+  markDirty(display, 0, 0, display->width(), display->height());
+  return delaytime;
+}
+
+// Working pages of a cross fade: the incoming image, and the mask step it shows through.
+static uint8_t crossStrips[2][SSD1306FUNC_MAX_COLUMNS];
+
+// Whether screen pixel (`x`, `y`) belongs to step `step` of `mask`, the same pixels `maskPages` covers.
+static bool isMaskPixel(const FadeMask& mask, uint16_t step, int16_t x, int16_t y) {
+  if (mask.tiles) return pgm_read_byte(mask.tiles + step * 8 + (x & 7)) & (1 << (y & 7));
+  int16_t period = mask.steps;
+  return ((mask.dx * x + mask.dy * y) % period + period) % period == (int16_t) step;
+}
+
+/// @brief Starts a non-blocking `crossFadeImages`. Call `tick()` until it returns `false`. See `crossFadeImages` for the parameters.
+void CrossFadeEffect::begin(Adafruit_SSD1306* display, FadeMask mask, long stepdelay, int16_t offset_x, int16_t offset_y, Image from, Image to) {
+  fromimage = ProgmemImageSource(from);
+  toimage = ProgmemImageSource(to);
+  begin(display, mask, stepdelay, offset_x, offset_y, fromimage, toimage);
+}
+
+/// @brief Starts a non-blocking `crossFadeImages` that reads its rows from `from` and `to`, which have to outlive the effect.
+void CrossFadeEffect::begin(Adafruit_SSD1306* display, FadeMask mask, long stepdelay, int16_t offset_x, int16_t offset_y, ImageSource& from, ImageSource& to) {
+  if (stepdelay < 0) stepdelay = 50;   // Recommended delay time
+
+  this->mask = mask;
+  this->stepdelay = stepdelay;
+  this->offset_x = offset_x;
+  this->offset_y = offset_y;
+  this->from = &from;
+  this->to = &to;
+  width = max(from.width, to.width);
+  height = max(from.height, to.height);
+  start(display);
+}
+
+// Draws `source` into the pixels of the effect's area that step `step` of `mask` covers, or into all of them when `mask` is
+// `NULL`, and marks the columns that changed. Returns whether any did.
+bool CrossFadeEffect::compose(ImageSource* source, const FadeMask* mask, uint16_t step) {
+  int16_t x = offset_x, y = offset_y, w = width, h = height;
+  if (!mapToPanel(display, x, y, w, h)) return false;
+
+  // Rotated screens test pixel by pixel, reading the source a row at a time
+  if (display->getRotation()) {
+    int16_t left = max(offset_x, 0), right = min(offset_x + width, display->width());
+    int16_t top = max(offset_y, 0), bottom = min(offset_y + height, display->height());
+    int16_t firstbyte = (left - offset_x) / 8;
+    int16_t lastbyte = min((right - offset_x + 7) / 8, (source->width + 7) / 8);
+    uint8_t line[BAND_BYTES];
+    bool changed = false;
+
+    for (int16_t py = top; py < bottom; py++) {
+      int16_t row = py - offset_y;
+      bool inside = row < source->height && firstbyte < lastbyte;
+      if (inside) source->read(row, 1, firstbyte, lastbyte - firstbyte, line);
+      for (int16_t px = left; px < right; px++) {
+        if (mask && !isMaskPixel(*mask, step, px, py)) continue;
+        int16_t col = px - offset_x;
+        bool on = inside && col < source->width && (line[col / 8 - firstbyte] & (0x80 >> (col & 7)));
+        if (display->getPixel(px, py) == on) continue;
+        display->drawPixel(px, py, on);
+        changed = true;
+      }
+    }
+    if (changed) markDirty(display, offset_x, offset_y, width, height);
+    return changed;
+  }
+
+  uint8_t* buffer = display->getBuffer();
+  int16_t columns = getPanelWidth(display);
+  bool changed = false;
+  for (int16_t page = y / 8; page <= (y + h - 1) / 8; page++) {
+    uint8_t rows = rowBits(page, y, y + h);
+    memset(crossStrips[0], 0, columns);
+    blitPages(display, crossStrips[0], page, page, x, x + w, offset_x, offset_y, source, ON);
+    if (mask) {
+      memset(crossStrips[1], 0, columns);
+      maskPages(display, crossStrips[1], page, page, *mask, step, ON);
+    }
+
+    // buf = (buf & ~mask) | (source & mask), keeping track of the columns that actually change
+    uint8_t* dest = buffer + page * columns;
+    int16_t first = -1, last = 0;
+    for (int16_t col = x; col < x + w; col++) {
+      uint8_t bits = mask ? crossStrips[1][col] & rows : rows;
+      uint8_t value = (dest[col] & ~bits) | (crossStrips[0][col] & bits);
+      if (value == dest[col]) continue;
+      dest[col] = value;
+      if (first < 0) first = col;
+      last = col;
+    }
+    if (first >= 0) {
+      markDirty(display, first, page * 8, last - first + 1, 8);
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+long CrossFadeEffect::step() {
+  // Frame 0 puts `from` in place. When it already is, as after a previous image, the first step follows at once
+  if (frame == 0) {
+    maskstep = 0;
+    if (compose(from, NULL, 0)) return stepdelay;
+  }
+
+  if (maskstep >= mask.steps) return EFFECT_DONE;
+  compose(to, &mask, maskstep++);
+  return stepdelay;
+}
+
+/// @brief Starts a non-blocking `drawVerticalScrollingBitmap`. Call `tick()` until it returns `false`. See `drawVerticalScrollingBitmap` for the parameters.
+void VerticalScrollEffect::begin(Adafruit_SSD1306* display, long initialdelay, long enddelay, long scrolldelay, int scrollstep, bool snaptoend, bool allowoverflow, int16_t offset_x, int16_t offset_y, int16_t end_y, Image bmp) {
+  image = ProgmemImageSource(bmp);
+  begin(display, initialdelay, enddelay, scrolldelay, scrollstep, snaptoend, allowoverflow, offset_x, offset_y, end_y, image);
+}
+
+/// @brief Starts a non-blocking `drawVerticalScrollingBitmap` that reads its rows from `source`, which has to outlive the effect.
+void VerticalScrollEffect::begin(Adafruit_SSD1306* display, long initialdelay, long enddelay, long scrolldelay, int scrollstep, bool snaptoend, bool allowoverflow, int16_t offset_x, int16_t offset_y, int16_t end_y, ImageSource& source) {
+  // Recommended/default values
+  if (initialdelay < 0) initialdelay = 500;
+  if (enddelay < 0) enddelay = 500;
+  if (scrolldelay < 0) scrolldelay = 5;
+
+  // Modify end_y values internally to be the absolute y-coordinate where scrolling will stop
+  // TODO: Review this
+  int16_t screenheight = display->height();
+  if (scrollstep > 0 && end_y <= 0) end_y = source.height;
+  else if (scrollstep > 0 && end_y + screenheight > source.height && !allowoverflow) end_y = source.height;
+  else if (scrollstep > 0) end_y += screenheight;
+  else if (scrollstep < 0 && end_y + screenheight > source.height && !allowoverflow) end_y = source.height - screenheight;
+  else if (scrollstep < 0 && end_y < 0 && !allowoverflow) end_y = 0;
+
+  this->initialdelay = initialdelay;
+  this->enddelay = enddelay;
+  this->scrolldelay = scrolldelay;
+  this->scrollstep = scrollstep;
+  this->snaptoend = snaptoend;
+  this->offset_x = offset_x;
+  this->offset_y = offset_y;
+  this->end_y = end_y;
+  this->source = &source;
+  position = scrollstep > 0 ? 0 : offset_y;
+  finished = false;
+  start(display);
+}
+
+void VerticalScrollEffect::drawAt(int16_t y, uint16_t color) {
+  blitBitmap(display, offset_x, y, source, color);
+  markDirty(display, offset_x, y, source->width, source->height);
+}
+
+// Moves the bitmap from where it was last drawn to `y`. On an unrotated screen its columns are shifted in the framebuffer and
+// only the rows that scroll into view are read from the source, so pixels under the bitmap move along with it; otherwise, or
+// when the two positions do not overlap, it is erased and drawn again.
+void VerticalScrollEffect::moveTo(int16_t y) {
+  int16_t delta = y - drawn_y;
+  if (!delta) return;
+
+  int16_t screenwidth = display->width();
+  int16_t screenheight = display->height();
+  int16_t startcol = offset_x > 0 ? offset_x : 0;
+  int16_t endcol = offset_x + source->width < screenwidth ? offset_x + source->width : screenwidth;
+  int16_t oldtop = constrain(drawn_y, 0, screenheight), oldbottom = constrain(drawn_y + source->height, 0, screenheight);
+  int16_t newtop = constrain(y, 0, screenheight), newbottom = constrain(y + source->height, 0, screenheight);
+  int16_t top = oldtop < newtop ? oldtop : newtop;
+  int16_t bottom = oldbottom > newbottom ? oldbottom : newbottom;
+
+  if (display->getRotation() || startcol >= endcol || (oldtop > newtop ? oldtop : newtop) >= (oldbottom < newbottom ? oldbottom : newbottom)) {
+    drawAt(drawn_y, OFF);
+    drawAt(y, ON);
+    drawn_y = y;
+    return;
+  }
+
+  shiftColumns(display, startcol, endcol, top, bottom, oldtop + delta, oldbottom + delta, delta);
+
+  // The rows that came into view trail the motion: above the shifted rows when moving down, below them when moving up
+  int16_t from = delta > 0 ? newtop : (oldbottom + delta > newtop ? oldbottom + delta : newtop);
+  int16_t to = delta > 0 ? (oldtop + delta < newbottom ? oldtop + delta : newbottom) : newbottom;
+  if (from < to) {
+    // Whole pages are drawn, but the rows of them that were shifted already hold the same pixels
+    int16_t firstpage = from >> 3, lastpage = (to - 1) >> 3;
+    blitPages(display, display->getBuffer() + firstpage * screenwidth, firstpage, lastpage, startcol, endcol, offset_x, y, source, ON);
+  }
+
+  markDirty(display, startcol, top, endcol - startcol, bottom - top);
+  drawn_y = y;
+}
+
+long VerticalScrollEffect::step() {
+  if (frame == 0) {
+    drawAt(offset_y, ON);
+    drawn_y = offset_y;
+    return initialdelay;
+  }
+  if (scrollstep == 0 || finished) return EFFECT_DONE;
+
+  int16_t screenheight = display->height();
+  if (scrollstep > 0) {
+    if (position + screenheight - offset_y < end_y) {
+      bool moved = true;
+      if (position + screenheight - offset_y + scrollstep < end_y) position+=scrollstep;
+      else if (position + screenheight - offset_y < end_y && !snaptoend) position++;
+      else moved = false;
+
+      if (moved) {
+        moveTo(-position + offset_y);
+        return scrolldelay;
+      }
+    }
+
+    moveTo(-(end_y - screenheight));
+  } else {
+    if (position < -end_y) {
+      bool moved = true;
+      if (position - scrollstep <= -end_y) position-=scrollstep;
+      else if (position <= -end_y && !snaptoend) position++;
+      else moved = false;
+
+      if (moved) {
+        moveTo(position);
+        return scrolldelay;
+      }
+    }
+
+    moveTo(-end_y);
+  }
+
+  finished = true;
+  return enddelay;
+}
+
+/// @brief Starts a non-blocking `drawHardwareScrollingBitmap`. Call `tick()` until it returns `false`. See `drawHardwareScrollingBitmap` for the parameters.
+void HardwareScrollEffect::begin(Adafruit_SSD1306* display, long initialdelay, long enddelay, long scrolldelay, int scrollstep, int16_t offset_x, int16_t end_y, Image bmp) {
+  image = ProgmemImageSource(bmp);
+  begin(display, initialdelay, enddelay, scrolldelay, scrollstep, offset_x, end_y, image);
+}
+
+/// @brief Starts a non-blocking `drawHardwareScrollingBitmap` that reads its rows from `source`, which has to outlive the effect.
+void HardwareScrollEffect::begin(Adafruit_SSD1306* display, long initialdelay, long enddelay, long scrolldelay, int scrollstep, int16_t offset_x, int16_t end_y, ImageSource& source) {
+  if (initialdelay < 0) initialdelay = 500;
+  if (enddelay < 0) enddelay = 500;
+  if (scrolldelay < 0) scrolldelay = 5;
+  if (end_y < 0) end_y = 0;
+
+  int16_t last = source.height - display->height();
+  if (last < 0) last = 0;
+
+  this->initialdelay = initialdelay;
+  this->enddelay = enddelay;
+  this->scrolldelay = scrolldelay;
+  this->scrollstep = scrollstep;
+  this->offset_x = offset_x;
+  this->source = &source;
+  position = scrollstep < 0 ? last : 0;
+  endposition = scrollstep < 0 ? end_y : last - end_y;
+  if (endposition < 0) endposition = 0;
+  if (endposition > last) endposition = last;
+  margin = (SSD1306_GDDRAM_ROWS - display->height()) / 2;
+  base = position - margin;
+  hardware = hasBus(display) && !display->getRotation();   // GDDRAM rows only line up with screen rows when unrotated
+  finished = false;
+  start(display);
+}
+
+void HardwareScrollEffect::setStartLine(int16_t line) {
+  finishFlush(display);
+  selectDisplay(display);
+  display->ssd1306_command(SSD1306_SETSTARTLINE | (line & (SSD1306_GDDRAM_ROWS - 1)));
+  countBytes(display, 1);
+}
+
+// Image row of the GDDRAM-high window from `base` that GDDRAM row `ramrow` holds.
+static int16_t windowRow(int16_t base, int16_t ramrow) {
+  return base + (((ramrow - base) % SSD1306_GDDRAM_ROWS) + SSD1306_GDDRAM_ROWS) % SSD1306_GDDRAM_ROWS;
+}
+
+// Renders and sends GDDRAM page `page`, reading only the image rows it holds.
+void HardwareScrollEffect::writePage(uint8_t page) {
+  finishFlush(display);
+
+  uint8_t strip[SSD1306FUNC_MAX_COLUMNS];
+  uint8_t band[8 * BAND_BYTES];
+  uint8_t rows[8];
+  uint8_t cols[8];
+  int16_t columns = display->width();
+  int16_t width = source->width;
+  int16_t bytewidth = (width + 7) / 8;
+  int16_t firstbyte = offset_x < 0 ? -offset_x / 8 : 0;
+  int16_t lastbyte = (columns - offset_x + 7) / 8 < bytewidth ? (columns - offset_x + 7) / 8 : bytewidth;
+
+  memset(strip, 0, columns);
+  if (firstbyte < lastbyte) {
+    uint8_t bytes = lastbyte - firstbyte;
+    memset(band, 0, sizeof(band));
+
+    // The page holds at most two runs of consecutive image rows, split where the window wraps around
+    for (uint8_t bit = 0; bit < 8;) {
+      int16_t row = windowRow(base, page * 8 + bit);
+      uint8_t run = 1;
+      while (bit + run < 8 && windowRow(base, page * 8 + bit + run) == row + run) run++;
+
+      int16_t from = row < 0 ? 0 : row;
+      int16_t to = row + run < source->height ? row + run : source->height;
+      if (from < to) source->read(from, to - from, firstbyte, bytes, band + (bit + from - row) * bytes);
+      bit += run;
+    }
+
+    for (uint8_t b = 0; b < bytes; b++) {
+      for (uint8_t i = 0; i < 8; i++) rows[i] = band[i * bytes + b];
+      transposeBlock(rows, cols);
+
+      int16_t left = (firstbyte + b) * 8;
+      for (uint8_t j = 0; j < 8 && left + j < width; j++) {
+        int16_t col = offset_x + left + j;
+        if (col >= 0 && col < columns) strip[col] = cols[j];
+      }
+    }
+  }
+
+  openWindow(display, 0, columns - 1, page, page);
+  sendData(display, strip, columns);
+}
+
+// Scrolls to `next`: rewrites only the RAM pages holding rows that enter the window, then moves the start line.
+void HardwareScrollEffect::moveTo(int16_t next) {
+  int16_t newbase = next - margin;
+  int16_t shift = newbase - base;
+  int16_t distance = shift < 0 ? -shift : shift;
+  uint8_t pages = 0;
+
+  if (distance >= SSD1306_GDDRAM_ROWS) pages = 0xFF;
+  else {
+    int16_t from = shift > 0 ? base + SSD1306_GDDRAM_ROWS : newbase;
+    for (int16_t row = from; row < from + distance; row++) pages |= 1 << (((row % SSD1306_GDDRAM_ROWS) + SSD1306_GDDRAM_ROWS) % SSD1306_GDDRAM_ROWS / 8);
+  }
+
+  // Rows already buffered off-screen can be shown first, which keeps the rewrite out of sight; otherwise the rewrite has to go first
+  bool ahead = distance <= margin;
+  if (ahead) setStartLine(next);
+  base = newbase;
+  for (uint8_t page = 0; page < SSD1306_GDDRAM_ROWS / 8; page++) {
+    if (pages & (1 << page)) writePage(page);
+  }
+  if (!ahead) setStartLine(next);
+  position = next;
+}
+
+// Redraws the current view into the framebuffer in the normal layout, so later drawing and flushes line up again.
+void HardwareScrollEffect::restoreLayout() {
+  display->clearDisplay();
+  blitBitmap(display, offset_x, -position, source, ON);
+  if (!hardware) {
+    flushScreen(display);
+    return;
+  }
+
+  // When the visible RAM rows don't overlap rows 0 to height-1, the framebuffer can be written there unseen before the start line snaps back
+  int16_t line = position & (SSD1306_GDDRAM_ROWS - 1);
+  int16_t screenheight = display->height();
+  bool offscreen = line >= screenheight && line + screenheight <= SSD1306_GDDRAM_ROWS;
+  if (!offscreen) setStartLine(0);
+  flushScreen(display);
+  if (offscreen) setStartLine(0);
+}
+
+long HardwareScrollEffect::step() {
+  if (finished) return EFFECT_DONE;
+
+  if (frame == 0) {
+    if (!hardware) {
+      restoreLayout();
+      return initialdelay;
+    }
+    for (uint8_t page = 0; page < SSD1306_GDDRAM_ROWS / 8; page++) writePage(page);
+    setStartLine(position);
+    return initialdelay;
+  }
+
+  if (scrollstep != 0 && position != endposition) {
+    int16_t next = position + scrollstep;
+    if ((scrollstep > 0 && next > endposition) || (scrollstep < 0 && next < endposition)) next = endposition;
+
+    if (hardware) moveTo(next);
+    else {
+      position = next;
+      restoreLayout();
+    }
+    return scrolldelay;
+  }
+
+  if (hardware) restoreLayout();
+  finished = true;
+  return enddelay;
+}
+
+/// @brief Starts a non-blocking `panImage`. Call `tick()` until it returns `false`. See `panImage` for the parameters.
+void PanEffect::begin(Adafruit_SSD1306* display, long framedelay, uint8_t easing, const PanPoint* path, uint8_t count, Image bmp) {
+  image = ProgmemImageSource(bmp);
+  begin(display, framedelay, easing, path, count, image);
+}
+
+/// @brief Starts a non-blocking `panImage` that reads its pixels from `source`, which has to outlive the effect.
+void PanEffect::begin(Adafruit_SSD1306* display, long framedelay, uint8_t easing, const PanPoint* path, uint8_t count, ImageSource& source) {
+  if (framedelay < 0) framedelay = 20;
+
+  this->framedelay = framedelay;
+  this->easing = easing;
+  this->path = path;
+  this->count = count;
+  this->source = &source;
+  start(display);
+}
+
+// Draws the whole view from scratch.
+void PanEffect::drawView() {
+  display->clearDisplay();
+  blitBitmap(display, -view_x, -view_y, source, ON);
+  markDirty(display, 0, 0, display->width(), display->height());
+}
+
+// Moves the view to (`x`,`y`). On an unrotated screen, the framebuffer is shifted by the move, across columns and then down
+// or up the pages, and only the column and row strips that came into view are read from the source.
+void PanEffect::moveTo(int16_t x, int16_t y) {
+  int16_t dx = x - view_x;
+  int16_t dy = y - view_y;
+  if (!dx && !dy) return;
+
+  int16_t width = display->width();
+  int16_t height = display->height();
+  int16_t pages = (height + 7) / 8;
+  view_x = x;
+  view_y = y;
+
+  if (display->getRotation() || abs(dx) >= width || abs(dy) >= height) {
+    drawView();
+    return;
+  }
+
+  uint8_t* buffer = display->getBuffer();
+  if (dx) {
+    for (int16_t page = 0; page < pages; page++) {
+      uint8_t* row = buffer + page * width;
+      if (dx > 0) {
+        memmove(row, row + dx, width - dx);
+        memset(row + width - dx, 0, dx);
+      } else {
+        memmove(row - dx, row, width + dx);
+        memset(row, 0, -dx);
+      }
+    }
+  }
+  if (dy) shiftColumns(display, 0, width, 0, height, -dy, height - dy, -dy);
+
+  // The column and row strips that came into view, drawn once both shifts are done
+  if (dx > 0) blitPages(display, buffer, 0, pages - 1, width - dx, width, -x, -y, source, ON);
+  else if (dx < 0) blitPages(display, buffer, 0, pages - 1, 0, -dx, -x, -y, source, ON);
+
+  if (dy) {
+    // Whole pages are drawn, but the rows of them that were shifted already hold the same pixels
+    int16_t firstpage = dy > 0 ? (height - dy) >> 3 : 0;
+    int16_t lastpage = dy > 0 ? pages - 1 : (-dy - 1) >> 3;
+    blitPages(display, buffer + firstpage * width, firstpage, lastpage, 0, width, -x, -y, source, ON);
+  }
+
+  markDirty(display, 0, 0, width, height);
+}
+
+// Eases `t`, which runs from `0` to `256` over a leg.
+static int16_t easePan(uint8_t easing, int16_t t) {
+  int16_t rest = 256 - t;
+  switch (easing) {
+    case PAN_EASE_IN: return (int32_t) t * t / 256;
+    case PAN_EASE_OUT: return 256 - (int32_t) rest * rest / 256;
+    case PAN_EASE_IN_OUT: return t < 128 ? (int32_t) t * t / 128 : 256 - (int32_t) rest * rest / 128;
+  }
+  return t;
+}
+
+long PanEffect::step() {
+  if (frame == 0) {
+    if (!count) return EFFECT_DONE;
+    view_x = path[0].x;
+    view_y = path[0].y;
+    point = 0;
+    legframe = legframes = 0;
+    drawView();
+    return framedelay;
+  }
+
+  // Each leg takes as many frames as fit in its duration, at least one
+  if (legframe == legframes) {
+    if (++point >= count) return EFFECT_DONE;
+    legframe = 0;
+    legframes = framedelay > 0 ? path[point].duration / framedelay : 1;
+    if (!legframes) legframes = 1;
+  }
+
+  legframe++;
+  const PanPoint& from = path[point - 1];
+  const PanPoint& to = path[point];
+  int16_t t = easePan(easing, (int32_t) legframe * 256 / legframes);
+  moveTo(from.x + (int32_t) (to.x - from.x) * t / 256, from.y + (int32_t) (to.y - from.y) * t / 256);
+  return framedelay;
+}
+
+// How `drawGrayPixels` turns a level into on or off: against the Bayer matrix, above a threshold, or by one of its bits.
+enum { GRAY_DITHER, GRAY_THRESHOLD, GRAY_PLANE };
+
+// 4x4 ordered dither thresholds, from 0 to 15.
+static const uint8_t bayerMatrix[4][4] = {
+  {0, 8, 2, 10},
+  {12, 4, 14, 6},
+  {3, 11, 1, 9},
+  {15, 7, 13, 5},
+};
+
+static inline uint8_t getGrayLevel(const GrayImage& image, int16_t x, int16_t y) {
+  uint16_t bit = x * image.bits;
+  uint8_t byte = pgm_read_byte(image.pixels + (uint32_t) y * ((image.width * image.bits + 7) / 8) + bit / 8);
+  return (byte >> (8 - image.bits - bit % 8)) & ((1 << image.bits) - 1);
+}
+
+static inline bool isGrayPixelOn(uint8_t level, uint8_t max, uint8_t mode, uint8_t value, int16_t x, int16_t y) {
+  if (mode == GRAY_THRESHOLD) return level > value;
+  if (mode == GRAY_PLANE) return level & (1 << value);
+  return level * 16 > bayerMatrix[y & 3][x & 3] * max;
+}
+
+// Draws `image` at (`x`,`y`) as 1-bit pixels, each on or off by `mode` and `value`, and marks it. Unrotated screens get whole
+// page bytes written at a time.
+static void drawGrayPixels(Adafruit_SSD1306* display, int16_t x, int16_t y, const GrayImage& image, uint8_t mode, uint8_t value) {
+  int16_t screenwidth = display->width();
+  int16_t screenheight = display->height();
+  int16_t startx = x > 0 ? x : 0;
+  int16_t endx = x + image.width < screenwidth ? x + image.width : screenwidth;
+  int16_t starty = y > 0 ? y : 0;
+  int16_t endy = y + image.height < screenheight ? y + image.height : screenheight;
+  if (startx >= endx || starty >= endy) return;
+  uint8_t max = (1 << image.bits) - 1;
+
+  if (!display->getRotation()) {
+    uint8_t* buffer = display->getBuffer();
+    for (int16_t page = starty >> 3; page <= (endy - 1) >> 3; page++) {
+      uint8_t cover = rowBits(page, starty, endy);
+      for (int16_t col = startx; col < endx; col++) {
+        uint8_t bits = 0;
+        for (uint8_t i = 0; i < 8; i++) {
+          int16_t row = page * 8 + i;
+          if ((cover & (1 << i)) && isGrayPixelOn(getGrayLevel(image, col - x, row - y), max, mode, value, col, row)) bits |= 1 << i;
+        }
+        uint8_t* dest = buffer + page * screenwidth + col;
+        *dest = (*dest & ~cover) | bits;
+      }
+    }
+  } else {
+    for (int16_t row = starty; row < endy; row++) {
+      for (int16_t col = startx; col < endx; col++) {
+        display->drawPixel(col, row, isGrayPixelOn(getGrayLevel(image, col - x, row - y), max, mode, value, col, row) ? ON : OFF);
+      }
+    }
+  }
+
+  markDirty(display, startx, starty, endx - startx, endy - starty);
+}
+
+/// @brief Starts a non-blocking `drawGrayscaleImage`. Call `tick()` until it returns `false`. See `drawGrayscaleImage` for the parameters.
+void GrayscaleEffect::begin(Adafruit_SSD1306* display, long duration, long framedelay, bool contrast, int16_t offset_x, int16_t offset_y, GrayImage img) {
+  if (duration < 0) duration = 2000;
+  if (framedelay < 0) framedelay = 0;
+
+  this->duration = duration;
+  this->framedelay = framedelay;
+  this->contrast = contrast;
+  this->offset_x = offset_x;
+  this->offset_y = offset_y;
+  pixels = img.pixels;
+  width = img.width;
+  height = img.height;
+  bits = img.bits;
+  start(display);
+}
+
+long GrayscaleEffect::step() {
+  GrayImage image = {pixels, width, height, bits};
+  if (frame == 0) startmillis = millis();
+
+  // Done: the dithered image stays on screen, at the contrast `begin()` of the display set. The register cannot be read
+  // back, so a contrast the sketch sent itself is not restored
+  if (duration && (long) (millis() - startmillis) >= duration) {
+    drawGrayPixels(display, offset_x, offset_y, image, GRAY_DITHER, 0);
+    if (contrast) display->dim(false);
+    return EFFECT_DONE;
+  }
+
+  // One frame per level, on while the level is above the frame's number: a pixel is on for `level` frames of each cycle
+  if (!contrast) {
+    drawGrayPixels(display, offset_x, offset_y, image, GRAY_THRESHOLD, frame % ((1 << bits) - 1));
+    return framedelay;
+  }
+
+  // One frame per bit, at a contrast halved for each less significant bit. The plane is sent before its contrast is set, so
+  // the two change together
+  uint8_t plane = bits - 1 - frame % bits;
+  drawGrayPixels(display, offset_x, offset_y, image, GRAY_PLANE, plane);
+  flushDirty(display);
+  uint8_t commands[] = {SSD1306_SETCONTRAST, (uint8_t) (0xFF >> (bits - 1 - plane))};
+  sendCommands(display, commands, sizeof(commands));
+  return framedelay;
+}
+
+// Applies one frame's delta: runs of `page, column, count` followed by `count` bytes to XOR into that page of the unrotated
+// panel, ended by a page of `0xFF`. Only the runs are marked, so only they are flushed.
+static void applyDelta(Adafruit_SSD1306* display, const uint8_t* delta) {
+  uint8_t* buffer = display->getBuffer();
+  DisplayState* state = getDisplayState(display);
+  int16_t width = getPanelWidth(display);
+  uint8_t pages = getPageCount(display);
+
+  for (;;) {
+    uint8_t page = pgm_read_byte(delta++);
+    if (page == 0xFF) break;
+    uint8_t col = pgm_read_byte(delta++);
+    uint8_t count = pgm_read_byte(delta++);
+
+    // Runs past the panel, e.g. from a taller animation, are skipped
+    if (page < pages && col + count <= width) {
+      uint8_t* dest = buffer + page * width + col;
+      for (uint8_t i = 0; i < count; i++) dest[i] ^= pgm_read_byte(delta + i);
+      if (state) markPanelDirty(state, page, col, col + count - 1);
+    }
+    delta += count;
+  }
+}
+
+/// @brief Starts a non-blocking `playAnimation` of delta frames. Call `tick()` until it returns `false`. See `playAnimation` for the parameters.
+void AnimationEffect::begin(Adafruit_SSD1306* display, const AnimationFrame* frames, uint16_t count, int16_t loops, uint16_t loopframe) {
+  deltas = frames;
+  images = NULL;
+  this->count = count;
+  this->loops = loops;
+  this->loopframe = loopframe < count ? loopframe : 0;
+  index = 0;
+  start(display);
+}
+
+/// @brief Starts a non-blocking `playAnimation` of `Image` frames. Call `tick()` until it returns `false`. See `playAnimation` for the parameters.
+void AnimationEffect::begin(Adafruit_SSD1306* display, const Image* frames, uint16_t count, long framedelay, int16_t offset_x, int16_t offset_y, int16_t loops) {
+  if (framedelay < 0) framedelay = 100;   // Recommended delay time
+
+  deltas = NULL;
+  images = frames;
+  this->count = count;
+  this->framedelay = framedelay;
+  this->offset_x = offset_x;
+  this->offset_y = offset_y;
+  this->loops = loops;
+  loopframe = 0;
+  index = 0;
+  previous = -1;
+  start(display);
+}
+
+long AnimationEffect::step() {
+  if (index >= count) {
+    if (!loops || !count) return EFFECT_DONE;
+    if (loops > 0) loops--;
+    index = loopframe;
+  }
+
+  if (deltas) {
+    applyDelta(display, deltas[index].delta);
+    return deltas[index++].duration;
+  }
+
+  // Image frames are XORed in, so XORing the previous one again takes it out and leaves what was beneath
+  const Image* image = &images[index];
+  if (previous >= 0) {
+    const Image* last = &images[previous];
+    blitImage(display, offset_x, offset_y, *last, SSD1306_INVERSE);
+    markDirty(display, offset_x, offset_y, last->width, last->height);
+  }
+  blitImage(display, offset_x, offset_y, *image, SSD1306_INVERSE);
+  markDirty(display, offset_x, offset_y, image->width, image->height);
+
+  previous = index++;
+  return framedelay;
+}
+
+/// @brief Fades the screen to full white/on with the `fadeGrid` effect, then draws the target bitmap/image with the `fadeCross` effect at specified (x,y) location.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param delaytime Number of milliseconds taken per step in the 3-step initial fade. Using negative values will use the recommended value (`50`).
+/// @param initdelaytime Number of milliseconds to wait after the initial fade before drawing the bitmap. Using negative values will use the recommended value (`500`).
+/// @param offset_x The x-coordinate of the image, starting at top-left.
+/// @param offset_y The y-coordinate of the image, starting at top-left.
+/// @param bmp The bitmap to be drawn.
+void fadeInGridBitmap(Adafruit_SSD1306* display, long delaytime, long initdelaytime, int16_t offset_x, int16_t offset_y, Image bmp) {
+  FadeInGridBitmapEffect effect;
+  effect.begin(display, delaytime, initdelaytime, offset_x, offset_y, bmp);
+  runEffect(effect);
+}
+
+/// @brief Same as the `Image` version of `fadeInGridBitmap`, reading the bitmap from `source`, e.g. a compressed `RleImageSource`.
+void fadeInGridBitmap(Adafruit_SSD1306* display, long delaytime, long initdelaytime, int16_t offset_x, int16_t offset_y, ImageSource& source) {
+  FadeInGridBitmapEffect effect;
+  effect.begin(display, delaytime, initdelaytime, offset_x, offset_y, source);
+  runEffect(effect);
+}
+
+/// @brief Changes the image at the specified (x,y) location from `from` to `to` in the steps of a fade mask, without fading to white in between. Each step only flushes the page columns that change.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param mask The mask whose steps `to` appears in, e.g. from `tools/ssd1306img.py --format mask`.
+/// @param stepdelay Number of milliseconds taken per step. Using negative values will use the recommended value (`50`).
+/// @param offset_x The x-coordinate of both images, starting at top-left.
+/// @param offset_y The y-coordinate of both images, starting at top-left.
+/// @param from The image on screen before the change. It is drawn first if it is not there yet.
+/// @param to The image on screen after the change. Pixels of the larger image's area that `to` does not cover end up off.
+void crossFadeImages(Adafruit_SSD1306* display, FadeMask mask, long stepdelay, int16_t offset_x, int16_t offset_y, Image from, Image to) {
+  CrossFadeEffect effect;
+  effect.begin(display, mask, stepdelay, offset_x, offset_y, from, to);
+  runEffect(effect);
+}
+
+/// @brief Same as the `Image` version of `crossFadeImages`, reading the images from `from` and `to`, e.g. compressed `RleImageSource`s.
+void crossFadeImages(Adafruit_SSD1306* display, FadeMask mask, long stepdelay, int16_t offset_x, int16_t offset_y, ImageSource& from, ImageSource& to) {
+  CrossFadeEffect effect;
+  effect.begin(display, mask, stepdelay, offset_x, offset_y, from, to);
+  runEffect(effect);
+}
+
+/// @brief Draws a bitmap, then scrolls it vertically to the specified y-coordinate.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param initialdelay Number of milliseconds to wait between drawing and scrolling the bitmap. Using negative values will use the recommended value (`500`).
+/// @param enddelay Number of milliseconds to delay after reaching the end of scrolling. Using negative values will use the recommended value (`500`).
+/// @param scrolldelay Number of milliseconds taken to scroll by one step. Using negative values will use the recommended value (`5`).
+/// @param scrollstep Number of pixels to skip per scrolling step. If `1`, scroll row by row; if `2`, skip every other row; etc. Use positive values for scrolling down, or negative values for scrolling up.
+/// @param snaptoend If `false`, and `scrollstep > 1`, `scrollstep` will revert to `1` once the remaining rows to scroll is less than `scrollstep`.
+/// @param allowoverflow  If `false`, scrolling will not exceed the bottom of the bitmap. Useful when bitmap height is not divisible by `scrollstep`.
+/// @param offset_x The x-coordinate of the image, starting at top-left. If this function is used with `fadeInGridBitmap`, use the `offset_x` value passed there.
+/// @param offset_y The x-coordinate of the image, starting at top-left. If this function is used with `fadeInGridBitmap`, use the `offset_y` value passed there.
+/// @param end_y A value "n" where scrolling will stop. For scroll-down, nth row from the bottom, and for scroll-up, nth row from the top.
+/// @param bmp The bitmap to be drawn.
+void drawVerticalScrollingBitmap(Adafruit_SSD1306* display, long initialdelay, long enddelay, long scrolldelay, int scrollstep, bool snaptoend, bool allowoverflow, int16_t offset_x, int16_t offset_y, int16_t end_y, Image bmp) {
+  VerticalScrollEffect effect;
+  effect.begin(display, initialdelay, enddelay, scrolldelay, scrollstep, snaptoend, allowoverflow, offset_x, offset_y, end_y, bmp);
+  runEffect(effect);
+}
+
+/// @brief Same as the `Image` version of `drawVerticalScrollingBitmap`, reading the bitmap from `source`. Each step reads only the rows on screen, never the whole bitmap.
+/// @param source Where the bitmap rows are read from. See the `Image` version for the other parameters.
+void drawVerticalScrollingBitmap(Adafruit_SSD1306* display, long initialdelay, long enddelay, long scrolldelay, int scrollstep, bool snaptoend, bool allowoverflow, int16_t offset_x, int16_t offset_y, int16_t end_y, ImageSource& source) {
+  VerticalScrollEffect effect;
+  effect.begin(display, initialdelay, enddelay, scrolldelay, scrollstep, snaptoend, allowoverflow, offset_x, offset_y, end_y, source);
+  runEffect(effect);
+}
+
+/// @brief Scrolls a bitmap taller than the screen using the display start line register, sending only the newly exposed rows per step instead of the whole framebuffer. The bitmap takes over the whole screen while scrolling; when done, the framebuffer holds the final view and the start line is back at `0`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param initialdelay Number of milliseconds to wait between drawing and scrolling the bitmap. Using negative values will use the recommended value (`500`).
+/// @param enddelay Number of milliseconds to delay after reaching the end of scrolling. Using negative values will use the recommended value (`500`).
+/// @param scrolldelay Number of milliseconds taken to scroll by one step. Using negative values will use the recommended value (`5`).
+/// @param scrollstep Number of pixels to skip per scrolling step. Use positive values for scrolling down from the top of the bitmap, or negative values for scrolling up from the bottom. The last step is shortened to land on `end_y`.
+/// @param offset_x The x-coordinate of the image, starting at top-left.
+/// @param end_y A value "n" where scrolling will stop. For scroll-down, nth row from the bottom, and for scroll-up, nth row from the top.
+/// @param bmp The bitmap to be drawn.
+void drawHardwareScrollingBitmap(Adafruit_SSD1306* display, long initialdelay, long enddelay, long scrolldelay, int scrollstep, int16_t offset_x, int16_t end_y, Image bmp) {
+  HardwareScrollEffect effect;
+  effect.begin(display, initialdelay, enddelay, scrolldelay, scrollstep, offset_x, end_y, bmp);
+  runEffect(effect);
+}
+
+/// @brief Same as the `Image` version of `drawHardwareScrollingBitmap`, reading the bitmap from `source`. Each step reads only the rows entering GDDRAM, so images thousands of rows tall can stream from SD or SPI flash.
+/// @param source Where the bitmap rows are read from. See the `Image` version for the other parameters.
+void drawHardwareScrollingBitmap(Adafruit_SSD1306* display, long initialdelay, long enddelay, long scrolldelay, int scrollstep, int16_t offset_x, int16_t end_y, ImageSource& source) {
+  HardwareScrollEffect effect;
+  effect.begin(display, initialdelay, enddelay, scrolldelay, scrollstep, offset_x, end_y, source);
+  runEffect(effect);
+}
+
+/// @brief Pans the screen over a bitmap larger than it, e.g. a map or a panorama, along a path of points. Each frame shifts the framebuffer and reads only the column and row strips that come into view, so the cost of a frame does not grow with the bitmap.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param framedelay Number of milliseconds per frame. Using negative values will use the recommended value (`20`).
+/// @param easing How each leg speeds up and slows down: `PAN_LINEAR`, `PAN_EASE_IN`, `PAN_EASE_OUT` or `PAN_EASE_IN_OUT`.
+/// @param path The points to pan through, starting at the first. Has to outlive the pan.
+/// @param count Number of points.
+/// @param bmp The bitmap to be panned over.
+void panImage(Adafruit_SSD1306* display, long framedelay, uint8_t easing, const PanPoint* path, uint8_t count, Image bmp) {
+  PanEffect effect;
+  effect.begin(display, framedelay, easing, path, count, bmp);
+  runEffect(effect);
+}
+
+/// @brief Same as the `Image` version of `panImage`, reading the bitmap from `source`, e.g. a map streamed from an SD card.
+/// @param source Where the bitmap rows are read from. See the `Image` version for the other parameters.
+void panImage(Adafruit_SSD1306* display, long framedelay, uint8_t easing, const PanPoint* path, uint8_t count, ImageSource& source) {
+  PanEffect effect;
+  effect.begin(display, framedelay, easing, path, count, source);
+  runEffect(effect);
+}
+
+/// @brief Draws a grayscale image as 1-bit pixels with a 4x4 ordered (Bayer) dither. The image is drawn opaque: its off pixels clear the screen under it.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param x The x-coordinate of the image, starting at top-left.
+/// @param y The y-coordinate of the image, starting at top-left.
+/// @param img The image, from `tools/ssd1306img.py --format gray`.
+void drawDitheredImage(Adafruit_SSD1306* display, int16_t x, int16_t y, GrayImage img) {
+  drawGrayPixels(display, x, y, img, GRAY_DITHER, 0);
+}
+
+/// @brief Shows a grayscale image by cycling it through 1-bit frames faster than the eye follows, then leaves it dithered. Each frame flushes only the image's area, so small images cycle fastest; fast I2C (see `setBusClock`) or SPI helps larger ones.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param duration Number of milliseconds to cycle for. `0` cycles until the effect is stopped, which only suits `GrayscaleEffect`. Using negative values will use the recommended value (`2000`).
+/// @param framedelay Number of milliseconds per frame. Using negative values will use the recommended value (`0`: as fast as the bus allows).
+/// @param contrast If `true`, one frame per bit of the levels, each at a contrast weighted by its bit, instead of one frame per level. Fewer frames per cycle, but the contrast register is shared by the whole screen, so other content flickers with it. When done, the contrast is back at the `Adafruit_SSD1306::begin()` default, as after `dim(false)`: a sketch that set its own contrast sends it again afterwards.
+/// @param offset_x The x-coordinate of the image, starting at top-left.
+/// @param offset_y The y-coordinate of the image, starting at top-left.
+/// @param img The image, from `tools/ssd1306img.py --format gray`.
+void drawGrayscaleImage(Adafruit_SSD1306* display, long duration, long framedelay, bool contrast, int16_t offset_x, int16_t offset_y, GrayImage img) {
+  GrayscaleEffect effect;
+  effect.begin(display, duration, framedelay, contrast, offset_x, offset_y, img);
+  runEffect(effect);
+}
+
+/// @brief Plays an animation stored as deltas, changing and flushing only what differs from one frame to the next.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param frames The frames, as written by `tools/ssd1306img.py --format delta`. The first frame's delta is drawn over what is already on the screen, a blank one for a fresh animation.
+/// @param count Number of frames.
+/// @param loops How many times to repeat the animation after playing it once. Using negative values repeats it forever.
+/// @param loopframe Frame each repeat starts at. Looping output of the converter ends with a frame back to the first, and repeats from frame `1`.
+void playAnimation(Adafruit_SSD1306* display, const AnimationFrame* frames, uint16_t count, int16_t loops, uint16_t loopframe) {
+  AnimationEffect effect;
+  effect.begin(display, frames, count, loops, loopframe);
+  runEffect(effect);
+}
+
+/// @brief Plays an animation of whole `Image` frames at the specified (x,y) location. Each frame is XORed over the screen, so drawing over a blank area shows it as-is, and only the frame's area is flushed.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param frames The frames, e.g. of a sprite.
+/// @param count Number of frames.
+/// @param framedelay Number of milliseconds each frame stays on screen. Using negative values will use the recommended value (`100`).
+/// @param offset_x The x-coordinate of the frames, starting at top-left.
+/// @param offset_y The y-coordinate of the frames, starting at top-left.
+/// @param loops How many times to repeat the animation after playing it once. Using negative values repeats it forever.
+void playAnimation(Adafruit_SSD1306* display, const Image* frames, uint16_t count, long framedelay, int16_t offset_x, int16_t offset_y, int16_t loops) {
+  AnimationEffect effect;
+  effect.begin(display, frames, count, framedelay, offset_x, offset_y, loops);
+  runEffect(effect);
+}
+
+
+
+// REGION FUNCTIONS
+
+// Maps a screen rectangle onto the panel and widens it to whole pages, as the buffer rows of `saveRegion` hold them. Returns
+// `false` if nothing of the rectangle is on the panel.
+static bool getRegionPages(Adafruit_SSD1306* display, int16_t& x, int16_t& y, int16_t& w, int16_t& h, uint8_t& firstpage, uint8_t& lastpage) {
+  if (!mapToPanel(display, x, y, w, h)) return false;
+  firstpage = y / 8;
+  lastpage = (y + h - 1) / 8;
+  return true;
+}
+
+/// @brief Fills a rectangle straight in the page layout of the framebuffer, and marks it for the next flush. Whole pages are set with `memset`, so page-aligned regions like the header label and dialog box cost one pass over their bytes.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param x The x-coordinate of the region, starting at top-left.
+/// @param y The y-coordinate of the region, starting at top-left.
+/// @param w Width of the region, in pixels.
+/// @param h Height of the region, in pixels.
+/// @param color Use `1` to turn the region on, `0` to turn it off, or `2` (`SSD1306_INVERSE`) to invert it.
+void fillRegion(Adafruit_SSD1306* display, int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  markDirty(display, x, y, w, h);
+
+  uint8_t firstpage, lastpage;
+  if (!getRegionPages(display, x, y, w, h, firstpage, lastpage)) return;
+
+  uint8_t* buffer = display->getBuffer();
+  int16_t width = getPanelWidth(display);
+  for (uint8_t page = firstpage; page <= lastpage; page++) {
+    uint8_t bits = rowBits(page, y, y + h);
+    uint8_t* dest = buffer + page * width + x;
+
+    if (bits == 0xFF && color <= ON) {
+      // Whole pages spanning the full width follow each other in the buffer, so one `memset` covers all of them
+      uint8_t pages = 1;
+      if (w == width) while (page + pages <= lastpage && rowBits(page + pages, y, y + h) == 0xFF) pages++;
+      memset(dest, color == ON ? 0xFF : 0x00, (pages - 1) * width + w);
+      page += pages - 1;
+    } else {
+      for (int16_t col = 0; col < w; col++) applyByte(dest + col, bits, color);
+    }
+  }
+}
+
+/// @brief Turns a rectangle of the framebuffer off, and marks it for the next flush. See `fillRegion`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param x The x-coordinate of the region, starting at top-left.
+/// @param y The y-coordinate of the region, starting at top-left.
+/// @param w Width of the region, in pixels.
+/// @param h Height of the region, in pixels.
+void clearRegion(Adafruit_SSD1306* display, int16_t x, int16_t y, int16_t w, int16_t h) {
+  fillRegion(display, x, y, w, h, OFF);
+}
+
+/// @brief Inverts a rectangle of the framebuffer, e.g. to highlight a choice, and marks it for the next flush. Inverting it again restores it.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param x The x-coordinate of the region, starting at top-left.
+/// @param y The y-coordinate of the region, starting at top-left.
+/// @param w Width of the region, in pixels.
+/// @param h Height of the region, in pixels.
+void invertRegion(Adafruit_SSD1306* display, int16_t x, int16_t y, int16_t w, int16_t h) {
+  fillRegion(display, x, y, w, h, SSD1306_INVERSE);
+}
+
+/// @brief Gets the number of bytes `saveRegion` needs to hold a rectangle: its width times the pages it touches, after rotation.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param x The x-coordinate of the region, starting at top-left.
+/// @param y The y-coordinate of the region, starting at top-left.
+/// @param w Width of the region, in pixels.
+/// @param h Height of the region, in pixels.
+/// @return The size of the buffer, in bytes, or `0` if the region is off the screen.
+uint16_t getRegionSize(Adafruit_SSD1306* display, int16_t x, int16_t y, int16_t w, int16_t h) {
+  uint8_t firstpage, lastpage;
+  if (!getRegionPages(display, x, y, w, h, firstpage, lastpage)) return 0;
+  return (uint16_t) w * (lastpage - firstpage + 1);
+}
+
+/// @brief Copies a rectangle of the framebuffer into a RAM buffer, e.g. to put it back with `restoreRegion` after a popup.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param x The x-coordinate of the region, starting at top-left.
+/// @param y The y-coordinate of the region, starting at top-left.
+/// @param w Width of the region, in pixels.
+/// @param h Height of the region, in pixels.
+/// @param dest A buffer of at least `getRegionSize` bytes for the same region.
+void saveRegion(Adafruit_SSD1306* display, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t* dest) {
+  uint8_t firstpage, lastpage;
+  if (!getRegionPages(display, x, y, w, h, firstpage, lastpage)) return;
+
+  uint8_t* buffer = display->getBuffer();
+  int16_t width = getPanelWidth(display);
+  for (uint8_t page = firstpage; page <= lastpage; page++, dest += w) memcpy(dest, buffer + page * width + x, w);
+}
+
+/// @brief Puts a rectangle saved by `saveRegion` back into the framebuffer, and marks it for the next flush. Rows of the touched pages outside the rectangle are left as they are now.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param x The x-coordinate of the region, as given to `saveRegion`.
+/// @param y The y-coordinate of the region, as given to `saveRegion`.
+/// @param w Width of the region, as given to `saveRegion`.
+/// @param h Height of the region, as given to `saveRegion`.
+/// @param source The buffer filled by `saveRegion`, with the display at the same rotation.
+void restoreRegion(Adafruit_SSD1306* display, int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* source) {
+  markDirty(display, x, y, w, h);
+
+  uint8_t firstpage, lastpage;
+  if (!getRegionPages(display, x, y, w, h, firstpage, lastpage)) return;
+
+  uint8_t* buffer = display->getBuffer();
+  int16_t width = getPanelWidth(display);
+  for (uint8_t page = firstpage; page <= lastpage; page++, source += w) {
+    uint8_t bits = rowBits(page, y, y + h);
+    uint8_t* dest = buffer + page * width + x;
+    if (bits == 0xFF) {
+      memcpy(dest, source, w);
+    } else {
+      for (int16_t col = 0; col < w; col++) dest[col] = (dest[col] & ~bits) | (source[col] & bits);
+    }
+  }
+}
+
+/// @brief Sends only the pages and columns of a rectangle to the display, leaving the rest of the pending changes for a later flush.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param x The x-coordinate of the region, starting at top-left.
+/// @param y The y-coordinate of the region, starting at top-left.
+/// @param w Width of the region, in pixels.
+/// @param h Height of the region, in pixels.
+void flushRegion(Adafruit_SSD1306* display, int16_t x, int16_t y, int16_t w, int16_t h) {
+  uint8_t firstpage, lastpage;
+  if (!getRegionPages(display, x, y, w, h, firstpage, lastpage)) return;
+
+  flushWindow(display, x, x + w - 1, firstpage, lastpage);
+
+  // Pages whose pending changes all lay inside the window are now up to date
+  DisplayState* state = getDisplayState(display);
+  if (!state) return;
+  for (uint8_t page = firstpage; page <= lastpage; page++) {
+    if (state->dirtyStart[page] >= x && state->dirtyEnd[page] <= x + w - 1) {
+      state->dirtyStart[page] = 0xFF;
+      state->dirtyEnd[page] = 0;
+    }
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// VISUAL NOVEL-ESQUE FUNCTIONS
+
+// TEXT PROCESSING FUNCTIONS
+
+// Height of a dialog text row in the glyph font, GFX font or text size the display is set to.
+static uint8_t getDialogLineHeight(Adafruit_SSD1306* display) {
+  GFXfont* gfxfont = display->*SSD1306Members::gfxFontMember;
+  if (getGlyphFont(display)) return 8;
+  if (gfxfont) return pgm_read_byte(&gfxfont->yAdvance) * display->*SSD1306Members::textsizeYMember;
+  return 8 * display->*SSD1306Members::textsizeYMember;
+}
+
+// Blanks the dialog area below the header label, for the next flush to send.
+static void clearDialogArea(Adafruit_SSD1306* display) {
+  clearRegion(display, 0, DIALOG_TOP, display->width(), display->height() - DIALOG_TOP);
+}
+
+/// @brief Starts a non-blocking `drawTimedDialogText`. Call `tick()` until it returns `false`. See `drawTimedDialogText` for the parameters.
+void DialogTextEffect::begin(Adafruit_SSD1306* display, uint8_t textspeed, long chardelay, long headerdelay, long timer, uint8_t timedinput, uint8_t timedend, uint8_t onebyone, const char* headertext, const char* dialog) {
+  // Recommended values
+  if (textspeed <= 0) textspeed = 1;
+  if (chardelay < 0) chardelay = 10;
+  if (headerdelay < 0) headerdelay = 200;
+  if (timer < 0) timer = 10000;
+
+  this->textspeed = textspeed;
+  this->chardelay = chardelay;
+  this->headerdelay = headerdelay;
+  this->timer = timer;
+  this->timedinput = timedinput;
+  this->timedend = timedend;
+  this->onebyone = onebyone;
+  this->headertext = headertext;
+  this->dialog = dialog;
+  size = strlen(dialog);
+  index = 0;
+  groupoffset = 0;
+  phase = DIALOG_HEADER;
+  start(display);
+
+  // Laid out up front, with the font and text size the dialog is drawn in
+  lineheight = getDialogLineHeight(display);
+  rows = max(1, (display->height() - DIALOG_TOP) / lineheight);
+  row = 0;
+  layoutpos = 0;
+  layoutLines();
+}
+
+/// @brief Checks whether the dialog has been shown in full and only waits for its final CTC.
+/// @return `true` during the CTC at the end of the dialog.
+bool DialogTextEffect::isWaiting() {
+  return running && phase == DIALOG_END_CTC;
+}
+
+// Returns how far a character moves the cursor, in pixels. CTC points take no space.
+int16_t DialogTextEffect::measureChar(char c) {
+  if (c == '`' || c == '\r') return 0;
+
+  const GlyphFont* font = getGlyphFont(display);
+  if (font) return (uint8_t) c >= font->first && (uint8_t) c <= font->last ? font->advance : 0;
+
+  uint8_t sizex = display->*SSD1306Members::textsizeXMember;
+  GFXfont* gfxfont = display->*SSD1306Members::gfxFontMember;
+  if (!gfxfont) return 6 * sizex;
+
+  uint16_t first = pgm_read_word(&gfxfont->first);
+  if ((uint8_t) c < first || (uint8_t) c > pgm_read_word(&gfxfont->last)) return 0;
+  GFXglyph* glyph = (GFXglyph*) pgm_read_ptr(&gfxfont->glyph) + ((uint8_t) c - first);
+  return pgm_read_byte(&glyph->xAdvance) * sizex;
+}
+
+// Lays out the dialog from `layoutpos` on, as many lines as `lines` holds. A word that does not fit moves to the next line, and
+// one wider than the whole line is split. The spaces or newline a line breaks at belong to neither line.
+void DialogTextEffect::layoutLines() {
+  int16_t width = display->width();
+  int pos = layoutpos;
+  linecount = 0;
+  lineindex = 0;
+
+  while (pos < size && linecount < SSD1306FUNC_DIALOG_LINES) {
+    DialogLine* line = &lines[linecount++];
+    int16_t x = 0;
+    int space = -1;                       // The last space the line can break at
+
+    line->start = pos;
+    for (; pos < size && dialog[pos] != '\n'; pos++) {
+      char c = dialog[pos];
+      int16_t advance = measureChar(c);
+      if (x + advance > width && pos > line->start) {
+        if (c != ' ' && space > line->start) pos = space;
+        break;
+      }
+      if (c == ' ') space = pos;
+      x += advance;
+    }
+    line->end = pos;
+
+    if (pos < size && dialog[pos] == '\n') pos++;
+    else while (pos < size && dialog[pos] == ' ') pos++;
+  }
+
+  layoutpos = pos;
+}
+
+// Reveals the next step of the dialog: `textspeed` characters, or in instant mode the rest of the page. Returns the delay before
+// the following step.
+long DialogTextEffect::revealText() {
+  // The line breaks are already decided, so Adafruit_GFX must not wrap on its own
+  bool wrap = display->*SSD1306Members::wrapMember;
+  display->setTextWrap(false);
+  long wait = revealLines();
+  display->setTextWrap(wrap);
+  return wait;
+}
+
+long DialogTextEffect::revealLines() {
+  while (linecount) {
+    if (index >= lines[lineindex].end) {
+      if (++lineindex == linecount) layoutLines();
+      if (!linecount) break;
+
+      index = lines[lineindex].start;
+      if (++row == rows) {
+        row = 0;
+        phase = DIALOG_PAGE_PENDING;
+        return onebyone ? chardelay : 1;
+      }
+      display->setCursor(0, DIALOG_TOP + row * lineheight);
+      continue;
+    }
+
+    // Groups of `textspeed` characters, flushed together. A CTC point flushes the group so far, then waits.
+    char c = dialog[index++];
+    if (c == '`') {
+      if (!onebyone) continue;
+      phase = DIALOG_CTC_PENDING;
+      return chardelay;
+    }
+
+    writeDialogChar(display, c);
+    if (onebyone && ++groupoffset == textspeed) {
+      groupoffset = 0;
+      return chardelay;
+    }
+  }
+
+  // The end CTC starts on the next tick, one character delay after the last group, or at once if that delay has passed
+  phase = DIALOG_END;
+  if (!onebyone) return 1;
+  if (!groupoffset) return 0;
+  groupoffset = 0;
+  return chardelay;
+}
+
+long DialogTextEffect::step() {
+  switch (phase) {
+    case DIALOG_HEADER:
+      display->setCursor(0, 0);
+      writeText(display, headertext);
+      display->setCursor(0, DIALOG_TOP);
+      phase = onebyone ? DIALOG_TEXT : DIALOG_INSTANT;
+      return headerdelay;
+
+    case DIALOG_INSTANT:
+    case DIALOG_TEXT:
+      return revealText();
+
+    case DIALOG_CTC_PENDING:
+      ctc.begin(display, CTC_SERIAL, timedinput, timer);
+      phase = DIALOG_CTC;
+      return 0;
+
+    case DIALOG_CTC:
+      if (ctc.tick(millis())) return 0;
+      phase = DIALOG_TEXT;
+      return revealText();
+
+    case DIALOG_PAGE_PENDING:
+      ctc.begin(display, CTC_SERIAL, timedinput, timer);
+      phase = DIALOG_PAGE_CTC;
+      return 0;
+
+    case DIALOG_PAGE_CTC:
+      if (ctc.tick(millis())) return 0;
+      clearDialogArea(display);
+      display->setCursor(0, DIALOG_TOP);
+      phase = onebyone ? DIALOG_TEXT : DIALOG_INSTANT;
+      return revealText();
+
+    case DIALOG_END:
+      ctc.begin(display, CTC_SERIAL, timedend, timer);
+      phase = DIALOG_END_CTC;
+      return 0;
+
+    case DIALOG_END_CTC:
+      if (ctc.tick(millis())) return 0;
+      break;
+  }
+
+  return EFFECT_DONE;
+}
+
+/// @brief Draws the specified dialog text with a header label. Allows both instant and animated text display. Uses serial monitor to invoke click-to-confirm (CTC).
+/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
+/// @param textspeed A positive integer, at least `1`. Number of characters revealed in one step. Only useful when `onebyone` is `true`. Using negative values will use the recommended value (`1`).
+/// @param chardelay Number of milliseconds taken to reveal a step. Using negative values will use the recommended value. Only useful when `onebyone` is `true`. Using negative values will use the recommended value (`10`).
+/// @param headerdelay Number of milliseconds to wait after showing header label before displaying the dialog text. Using negative values will use the recommended value (`200`).
+/// @param onebyone If `true`, animate the text display by revealing n characters at a time, with n = `textspeed`.
+/// @param headertext A string literal, the header label.
+/// @param dialog A string literal, the dialog to be displayed. Use the " ` " character to invoke CTC midway through a dialog. Words wrap at the screen edge, and text past the bottom continues on a new page after a CTC.
+void drawDialogText(Adafruit_SSD1306* display, uint8_t textspeed, long chardelay, long headerdelay, uint8_t onebyone, const char* headertext, const char* dialog) {
+  DialogTextEffect effect;
+  effect.begin(display, textspeed, chardelay, headerdelay, 0, false, false, onebyone, headertext, dialog);
+  runEffect(effect);
+}
+
+/// @brief Draws the specified dialog text with a header label. Allows both instant and animated text display. Uses serial monitor to invoke click-to-confirm (CTC), or a timer for auto-progression.
+/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
+/// @param textspeed A positive integer, at least `1`. Number of characters revealed in one step. Only useful when `onebyone` is `true`. Using negative values will use the recommended value (`1`).
+/// @param chardelay Number of milliseconds taken to reveal a step. Using negative values will use the recommended value. Only useful when `onebyone` is `true`. Using negative values will use the recommended value (`10`).
+/// @param headerdelay Number of milliseconds to wait after showing header label before displaying the dialog text. Using negative values will use the recommended value (`200`).
+/// @param timer Number of milliseconds for the timed CTC. Using negative values will use the recommended value (`10000`).
+/// @param timedinput If `true`, enable timer aside from serial monitor for midway CTCs. Otherwise, only use serial monitor.
+/// @param timedend If `true`, enable timer aside from serial monitor for CTC at the end of the dialog. Otherwise, only use serial monitor.
+/// @param onebyone If `true`, animate the text display by revealing n characters at a time, with n = `textspeed`.
+/// @param headertext A string literal, the header label.
+/// @param dialog A string literal, the dialog to be displayed. Use the " ` " character to invoke CTC midway through the dialog. Words wrap at the screen edge, and text past the bottom continues on a new page after a CTC.
+void drawTimedDialogText(Adafruit_SSD1306* display, uint8_t textspeed, long chardelay, long headerdelay, long timer, uint8_t timedinput, uint8_t timedend, uint8_t onebyone, const char* headertext, const char* dialog) {
+  DialogTextEffect effect;
+  effect.begin(display, textspeed, chardelay, headerdelay, timer, timedinput, timedend, onebyone, headertext, dialog);
+  runEffect(effect);
+}
+
+
+/// @brief Clears the header label on a displayed dialog screen.
+/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
+void clearHeaderText(Adafruit_SSD1306* display) {
+  clearRegion(display, 0, 0, display->width(), DIALOG_TOP);
+  flushRegion(display, 0, 0, display->width(), DIALOG_TOP);
+}
+
+/// @brief Clears the dialog section on a displayed dialog screen.
+/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
+void clearDialogText(Adafruit_SSD1306* display) {
+  clearDialogArea(display);
+  flushRegion(display, 0, DIALOG_TOP, display->width(), display->height() - DIALOG_TOP);
+}
+
+
+
+// DELAY/INPUT FUNCTIONS
+
+static ConfirmCallback confirmCallback = NULL;
+
+/// @brief Adds a confirm input to every CTC wait, next to its serial monitor or GPIO button. Pass `NULL` to remove it.
+/// @param callback Called each time a CTC wait checks its input. Returns `true` to confirm.
+void setConfirmCallback(ConfirmCallback callback) {
+  confirmCallback = callback;
+}
+
+/// @brief Starts a non-blocking click-to-confirm (CTC) wait. Call `tick()` until it returns `false`.
+/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
+/// @param button The GPIO pin to wait on, or `CTC_SERIAL` to wait on the serial monitor.
+/// @param timed If `true`, the wait also ends after `timerMS` milliseconds.
+/// @param timerMS CTC timer, in milliseconds. Only used when `timed` is `true`.
+void CtcEffect::begin(Adafruit_SSD1306* display, uint8_t button, bool timed, long timerMS) {
+  this->button = button;
+  this->timed = timed;
+  this->timerMS = timerMS;
+  baseX = display->getCursorX();
+  baseY = display->getCursorY();
+  color = 0;
+
+  if (button == CTC_SERIAL) while (Serial.available()) Serial.read();   // clear any serial artifacts
+  released = button == CTC_SERIAL;
+  level = released ? false : digitalRead(button);
+
+  basetime = millis();
+  blinkat = basetime + 500;
+  changed = basetime;
+  start(display);
+  renderIndicator();
+}
+
+// The indicator is a 12x8 overlay in the top-right corner. Both of its states are rendered once into panel bytes, so a blink
+// only copies those bytes back and flushes their window. Hiding it restores whatever was beneath.
+void CtcEffect::renderIndicator() {
+  int16_t x = display->width() - 12, y = 0, w = 12, h = 8;
+  indicatorcols = 0;
+  if (!mapToPanel(display, x, y, w, h)) return;
+
+  indicatorcol = x;
+  indicatorpage = y / 8;
+  indicatorpages = (y + h - 1) / 8 - indicatorpage + 1;
+  if (w * indicatorpages > (int16_t) sizeof(indicator[0])) return;
+  indicatorcols = w;
+
+  copyIndicator(indicator[0], false);
+
+  // Always the built-in font at size 1, whatever the dialog text uses
+  uint8_t textsizex = display->*SSD1306Members::textsizeXMember;
+  uint8_t textsizey = display->*SSD1306Members::textsizeYMember;
+  GFXfont* font = display->*SSD1306Members::gfxFontMember;
+  display->setFont(NULL);
+  display->setTextSize(1);
+  display->setTextColor(1);
+  display->setCursor(display->width() - 12, 0);
+  writeChar(display, NULL, '>');
+  writeChar(display, NULL, '>');
+  display->setFont(font);
+  display->*SSD1306Members::textsizeXMember = textsizex;
+  display->*SSD1306Members::textsizeYMember = textsizey;
+  display->setCursor(baseX, baseY);
+
+  copyIndicator(indicator[1], false);
+  copyIndicator(indicator[0], true);
+}
+
+// Copies the indicator's panel bytes out of the framebuffer, or back into it when `restore` is `true`.
+void CtcEffect::copyIndicator(uint8_t* bytes, bool restore) {
+  uint8_t* buffer = display->getBuffer() + indicatorpage * getPanelWidth(display) + indicatorcol;
+  for (uint8_t page = 0; page < indicatorpages; page++) {
+    if (restore) memcpy(buffer, bytes, indicatorcols);
+    else memcpy(bytes, buffer, indicatorcols);
+    buffer += getPanelWidth(display);
+    bytes += indicatorcols;
+  }
+}
+
+void CtcEffect::showIndicator(uint8_t shown) {
+  if (!indicatorcols) return;
+  copyIndicator(indicator[shown], true);
+  markDirty(display, display->width() - 12, 0, 12, 8);
+}
+
+long CtcEffect::step() {
+  unsigned long now = millis();
+
+  // The callback confirms even while the button from the previous CTC is still held
+  bool confirmed = confirmCallback && confirmCallback();
+  if (!confirmed && button == CTC_SERIAL) {
+    confirmed = Serial.available();
+  } else if (!confirmed) {
+    // A level only counts once every poll for `SSD1306FUNC_DEBOUNCE_MS` has read it. The button is polled rather than
+    // given an interrupt, so the sketch keeps its own handlers on the pin and each wait keeps its own debounce state
+    bool reading = digitalRead(button);
+    if (reading != level) {
+      level = reading;
+      changed = now;
+    }
+    bool settled = now - changed >= SSD1306FUNC_DEBOUNCE_MS;
+
+    // GPIO waits start once the button from the previous CTC has been released
+    if (!released) {
+      if (!settled || level) return 0;
+      released = true;
+      basetime = now;
+      blinkat = now + 500;
+    }
+    confirmed = settled && level;
+  }
+
+  if (!confirmed && !(timed && (long) (now - basetime) >= timerMS)) {
+    // Blinks on a fixed 500 ms schedule. In between, `idle()` lets the MCU sleep until an input or the next timer tick
+    if ((long) (now - blinkat) >= 0) {
+      blinkat += 500;
+      if ((long) (now - blinkat) >= 0) blinkat = now + 500;
       color = !color;
-      display->setCursor(116, 0);
-      display->setTextColor(color);
-      display->write(">>");
-      display->display();
+      showIndicator(color);
     }
+    return 0;
   }
 
-  display->setCursor(116, 0);
-  display->setTextColor(0);
-  display->write(">>");
-  display->display();
+  showIndicator(0);
 
   while (Serial.available()) Serial.read();   // clear serial buffer for next CTC call
   display->setCursor(baseX, baseY);
   display->setTextColor(1);
-}
\ No newline at end of file
+  return EFFECT_DONE;
+}
+
+/// @brief Checks whether the wait is still running. A CTC wait has nothing to draw but its indicator.
+/// @return `true` until the wait ends.
+bool CtcEffect::isWaiting() {
+  return running;
+}
+
+/// @brief Use serial monitor to wait for a user input. Displays a CTC indicator at the bottom-right corner.
+/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
+void ctcSerial(Adafruit_SSD1306* display) {
+  CtcEffect effect;
+  effect.begin(display, CTC_SERIAL, false, 0);
+  runEffect(effect);
+}
+
+/// @brief Use serial monitor to wait for a user input, or use a timer. Displays a CTC indicator at the bottom-right corner.
+/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
+/// @param timerMS CTC timer, in milliseconds.
+void ctcTimedSerial(Adafruit_SSD1306* display, long timerMS) {
+  CtcEffect effect;
+  effect.begin(display, CTC_SERIAL, true, timerMS);
+  runEffect(effect);
+}
+
+
+
+// CHOICE MENU FUNCTIONS
+
+// Debounces a menu button like a CTC button. Returns `true` once per press, when its high level has held for
+// `SSD1306FUNC_DEBOUNCE_MS`. A button already held when the menu begins only counts after it has been released.
+static bool pollButton(uint8_t pin, bool& level, bool& held, unsigned long& changed, unsigned long now) {
+  bool reading = digitalRead(pin);
+  if (reading != level) {
+    level = reading;
+    changed = now;
+  }
+  if (now - changed < SSD1306FUNC_DEBOUNCE_MS || level == held) return false;
+  held = level;
+  return held;
+}
+
+/// @brief Starts a non-blocking `drawChoiceMenu`. Call `tick()` until it returns `false`, then read the option with `getChoice()`. See `drawChoiceMenu` for the parameters.
+void ChoiceEffect::begin(Adafruit_SSD1306* display, uint8_t button, uint8_t nextbutton, const char* const* options, uint8_t count) {
+  this->button = button;
+  this->nextbutton = nextbutton;
+  this->options = options;
+  this->count = count;
+  selected = 0;
+  first = 0;
+  start(display);
+
+  lineheight = getDialogLineHeight(display);
+  rows = max(1, (display->height() - DIALOG_TOP) / lineheight);
+
+  unsigned long now = millis();
+  if (button == CTC_SERIAL) {
+    while (Serial.available()) Serial.read();   // clear any serial artifacts
+  } else {
+    level = held = digitalRead(button);
+    nextlevel = nextheld = digitalRead(nextbutton);
+    changed = nextchanged = now;
+  }
+  linestarted = false;
+  lastchar = '\0';
+
+  if (!count) return;
+  drawOptions();
+  invertOption(selected);
+}
+
+/// @brief Gets the option the menu ended on.
+/// @return Index of the option in `options`.
+uint8_t ChoiceEffect::getChoice() {
+  return selected;
+}
+
+// Draws the options from `first` on into the dialog area, one per row, without wrapping.
+void ChoiceEffect::drawOptions() {
+  clearDialogArea(display);
+
+  bool wrap = display->*SSD1306Members::wrapMember;
+  display->setTextWrap(false);
+  for (uint8_t row = 0; row < rows && first + row < count; row++) {
+    display->setCursor(2, DIALOG_TOP + row * lineheight);
+    writeText(display, options[first + row]);
+  }
+  display->setTextWrap(wrap);
+  display->setCursor(0, DIALOG_TOP);
+}
+
+void ChoiceEffect::invertOption(uint8_t option) {
+  invertRegion(display, 0, DIALOG_TOP + (option - first) * lineheight, display->width(), lineheight);
+}
+
+void ChoiceEffect::select(uint8_t option) {
+  if (option >= first && option < first + rows) {
+    invertOption(selected);
+    selected = option;
+    invertOption(selected);
+    return;
+  }
+
+  // Scrolled past the rows that fit: the list moves so the option is on its first or last row
+  first = option < first ? option : option - rows + 1;
+  selected = option;
+  drawOptions();
+  invertOption(selected);
+}
+
+long ChoiceEffect::step() {
+  if (!count) return EFFECT_DONE;
+
+  unsigned long now = millis();
+  bool confirmed = false;
+  uint8_t option = selected;
+
+  if (button == CTC_SERIAL) {
+    // A digit picks its option, `+`/`n` and `-`/`p` step through them, and an empty line confirms
+    while (!confirmed && Serial.available()) {
+      char c = Serial.read();
+      if (c == '\n' && lastchar == '\r') {
+        // The second half of a CRLF line end
+      } else if (c == '\r' || c == '\n') {
+        confirmed = !linestarted;
+        linestarted = false;
+      } else {
+        linestarted = true;
+        if (c >= '1' && c <= '9' && c - '1' < count) option = c - '1';
+        else if (c == '+' || c == 'n') option = option + 1 < count ? option + 1 : 0;
+        else if (c == '-' || c == 'p') option = option ? option - 1 : count - 1;
+      }
+      lastchar = c;
+    }
+  } else {
+    if (pollButton(nextbutton, nextlevel, nextheld, nextchanged, now)) option = option + 1 < count ? option + 1 : 0;
+    if (pollButton(button, level, held, changed, now)) confirmed = true;
+  }
+  if (confirmCallback && confirmCallback()) confirmed = true;
+
+  if (option != selected) select(option);
+  if (!confirmed) return 0;
+
+  while (Serial.available()) Serial.read();   // clear serial buffer for next CTC call
+  return EFFECT_DONE;
+}
+
+/// @brief Shows a menu of options in the dialog area, e.g. after `drawDialogText`, and waits until one is chosen. The selected option is shown inverted.
+/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
+/// @param button The GPIO pin that confirms the selected option, or `CTC_SERIAL` to use the serial monitor. There, a digit selects its option, `+`/`n` and `-`/`p` move the selection, and an empty line confirms. The confirm callback, if set, confirms as well.
+/// @param nextbutton The GPIO pin that moves the selection to the next option, wrapping around. Ignored with `CTC_SERIAL`.
+/// @param options The option texts, drawn one per row in the display's font. Options past the rows that fit scroll into view.
+/// @param count Number of entries in `options`.
+/// @return Index of the chosen option.
+uint8_t drawChoiceMenu(Adafruit_SSD1306* display, uint8_t button, uint8_t nextbutton, const char* const* options, uint8_t count) {
+  ChoiceEffect effect;
+  effect.begin(display, button, nextbutton, options, count);
+  runEffect(effect);
+  return effect.getChoice();
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// SCENE SCRIPT FUNCTIONS
+
+/// @brief Starts a non-blocking `playScene` of a script in PROGMEM. Call `tick()` until it returns `false`. See `playScene` for the parameters.
+void SceneEffect::begin(Adafruit_SSD1306* display, const uint8_t* script, ImageSource** images, uint8_t imagecount) {
+  this->script = script;
+  this->reader = NULL;
+  this->images = images;
+  this->imagecount = imagecount;
+  pos = 0;
+  cachecount = 0;
+  current = NULL;
+
+  // The dialog defaults, until the script sets its own
+  header[0] = '\0';
+  textspeed = 1;
+  chardelay = 10;
+  headerdelay = 200;
+  timer = 10000;
+  prefetching = false;
+  prefetched = false;
+  start(display);
+}
+
+/// @brief Starts a non-blocking `playScene` of a script read through `reader`, e.g. from a file on an SD card. Call `tick()` until it returns `false`.
+void SceneEffect::begin(Adafruit_SSD1306* display, ImageReader reader, void* context, ImageSource** images, uint8_t imagecount) {
+  begin(display, (const uint8_t*) NULL, images, imagecount);
+  this->reader = reader;
+  this->context = context;
+}
+
+// Reads the next script byte. A reader is asked for a few bytes at a time, which covers most opcodes with their arguments.
+uint8_t SceneEffect::next() {
+  if (!reader) return pgm_read_byte(script + pos++);
+
+  if (pos < cachepos || pos >= cachepos + cachecount) {
+    cachepos = pos;
+    cachecount = sizeof(cache);
+    reader(context, pos, cache, sizeof(cache));
+  }
+  return cache[pos++ - cachepos];
+}
+
+uint16_t SceneEffect::nextWord() {
+  uint8_t low = next();
+  return low | (uint16_t) next() << 8;
+}
+
+// Copies a script string into `dest`, cutting it to the `size - 1` characters that fit.
+void SceneEffect::nextString(char* dest, uint16_t size) {
+  uint16_t length = 0;
+  for (char c = next(); c; c = next()) {
+    if (length + 1 < size) dest[length++] = c;
+  }
+  dest[length] = '\0';
+}
+
+// Reads an image number, returning its source or `NULL` if the sketch passed no such image.
+ImageSource* SceneEffect::nextImage() {
+  uint8_t index = next();
+  return index < imagecount ? images[index] : NULL;
+}
+
+// The mask of the fade function matching a `SCENE_FADE` kind, with `steps` for the line fades.
+static FadeMask getSceneMask(uint8_t kind, uint8_t steps) {
+  FadeMask mask = {NULL, steps, 1, 1};
+  if (kind == SCENE_FADE_GRID) mask = gridMask;
+  else if (kind == SCENE_FADE_DISSOLVE) mask = dissolveMask;
+  else if (kind == SCENE_FADE_CROSS) mask.steps = 2;
+  else if (kind == SCENE_FADE_VERTICAL) mask.dy = 0;
+  else if (kind == SCENE_FADE_HORIZONTAL) mask.dx = 0;
+  return mask;
+}
+
+// Hands the following ticks to `effect`, which the caller has just begun.
+long SceneEffect::play(SSD1306Effect& effect) {
+  current = &effect;
+  return 0;
+}
+
+// Whether an opcode draws or sets up all it does at once, without a wait, input or an effect of its own.
+static bool isInstantOpcode(uint8_t opcode) {
+  return opcode == SCENE_HEADER || opcode == SCENE_SPEED || opcode == SCENE_CLEAR || opcode == SCENE_BLIT || opcode == SCENE_JUMP;
+}
+
+// Runs the instant opcodes that follow a wait into the second framebuffer, while the wait is still running. They are left out of
+// the dirty tracking until `applyPrefetch()` copies their changes in, so the wait's own flushes don't send them early.
+void SceneEffect::prefetch() {
+  prefetched = true;
+#if SSD1306FUNC_SCENE_PREFETCH
+  memset(prefetchStart, 0xFF, sizeof(prefetchStart));
+  memset(prefetchEnd, 0, sizeof(prefetchEnd));
+
+  uint16_t opcodepos = pos;
+  bool instant = isInstantOpcode(next());
+  pos = opcodepos;
+
+  DisplayState* state = getDisplayState(display);
+  uint16_t size = (uint16_t) getPanelWidth(display) * getPageCount(display);
+  if (!instant || !state) return;
+  if (!state->back) state->back = (uint8_t*) malloc(size);
+  if (!state->back) return;
+
+  uint8_t dirtyStart[SSD1306FUNC_MAX_PAGES];
+  uint8_t dirtyEnd[SSD1306FUNC_MAX_PAGES];
+  memcpy(dirtyStart, state->dirtyStart, sizeof(dirtyStart));
+  memcpy(dirtyEnd, state->dirtyEnd, sizeof(dirtyEnd));
+  clearDirty(state);
+
+  uint8_t* buffer = display->getBuffer();
+  memcpy(state->back, buffer, size);
+  display->*SSD1306Members::bufferMember = state->back;
+  prefetching = true;
+  runScript();
+  prefetching = false;
+  display->*SSD1306Members::bufferMember = buffer;
+
+  memcpy(prefetchStart, state->dirtyStart, sizeof(prefetchStart));
+  memcpy(prefetchEnd, state->dirtyEnd, sizeof(prefetchEnd));
+  memcpy(state->dirtyStart, dirtyStart, sizeof(dirtyStart));
+  memcpy(state->dirtyEnd, dirtyEnd, sizeof(dirtyEnd));
+#endif
+}
+
+// Copies what `prefetch()` drew ahead into the framebuffer once the wait has ended, and marks it for the next flush.
+void SceneEffect::applyPrefetch() {
+  prefetched = false;
+#if SSD1306FUNC_SCENE_PREFETCH
+  DisplayState* state = getDisplayState(display);
+  if (!state || !state->back) return;
+
+  uint8_t* buffer = display->getBuffer();
+  int16_t width = getPanelWidth(display);
+  for (uint8_t page = 0; page < getPageCount(display); page++) {
+    if (prefetchStart[page] > prefetchEnd[page]) continue;
+    uint16_t offset = page * width + prefetchStart[page];
+    memcpy(buffer + offset, state->back + offset, prefetchEnd[page] - prefetchStart[page] + 1);
+    markPanelDirty(state, page, prefetchStart[page], prefetchEnd[page]);
+  }
+#endif
+}
+
+long SceneEffect::step() {
+  if (current) {
+    if (current->tick(millis())) {
+      // While the wait runs, what follows it is drawn ahead, so it only has to be flushed once the wait ends
+      if (!prefetched && current->isWaiting()) prefetch();
+      return 0;
+    }
+    if (prefetched) applyPrefetch();
+    if (current == &choice) pos = targets[choice.getChoice()];
+    current = NULL;
+  }
+
+  return runScript();
+}
+
+// Runs opcodes until one starts an effect or a wait. While `prefetching`, it stops before the first opcode that is not instant.
+long SceneEffect::runScript() {
+  for (;;) {
+    uint16_t opcodepos = pos;
+    uint8_t opcode = next();
+    if (prefetching && !isInstantOpcode(opcode)) {
+      pos = opcodepos;
+      return 0;
+    }
+
+    switch (opcode) {
+      case SCENE_HEADER:
+        nextString(header, sizeof(header));
+        break;
+
+      case SCENE_SPEED:
+        textspeed = next();
+        chardelay = nextWord();
+        headerdelay = nextWord();
+        timer = nextWord();
+        break;
+
+      case SCENE_DIALOG: {
+        uint8_t flags = next();
+        nextString(text, sizeof(text));
+        dialog.begin(display, textspeed, chardelay, headerdelay, timer, flags & SCENE_TIMED_INPUT, flags & SCENE_TIMED_END, flags & SCENE_ONE_BY_ONE, header, text);
+        return play(dialog);
+      }
+
+      case SCENE_CLEAR: {
+        uint8_t flags = next();
+        if (flags & SCENE_CLEAR_SCREEN) {
+          display->clearDisplay();
+          markDirty(display, 0, 0, display->width(), display->height());
+        }
+        if (flags & SCENE_CLEAR_HEADER) {
+          clearRegion(display, 0, 0, display->width(), DIALOG_TOP);
+        }
+        if (flags & SCENE_CLEAR_DIALOG) clearDialogArea(display);
+        break;
+      }
+
+      case SCENE_CTC: {
+        uint8_t button = next();
+        uint16_t ms = nextWord();
+        ctc.begin(display, button, ms != 0, ms);
+        return play(ctc);
+      }
+
+      case SCENE_FADE: {
+        uint8_t kind = next();
+        uint8_t steps = next();
+        uint16_t stepdelay = nextWord();
+        uint16_t state = next();
+        fade.begin(display, getSceneMask(kind, steps), stepdelay, state);
+        return play(fade);
+      }
+
+      case SCENE_CROSS: {
+        ImageSource* from = nextImage();
+        ImageSource* to = nextImage();
+        int16_t x = nextWord();
+        int16_t y = nextWord();
+        uint8_t kind = next();
+        uint8_t steps = next();
+        uint16_t stepdelay = nextWord();
+        if (!from || !to) break;
+        cross.begin(display, getSceneMask(kind, steps), stepdelay, x, y, *from, *to);
+        return play(cross);
+      }
+
+      case SCENE_IMAGE: {
+        ImageSource* source = nextImage();
+        int16_t x = nextWord();
+        int16_t y = nextWord();
+        uint16_t delaytime = nextWord();
+        uint16_t initdelaytime = nextWord();
+        if (!source) break;
+        image.begin(display, delaytime, initdelaytime, x, y, *source);
+        return play(image);
+      }
+
+      case SCENE_BLIT: {
+        ImageSource* source = nextImage();
+        int16_t x = nextWord();
+        int16_t y = nextWord();
+        uint8_t color = next();
+        if (!source) break;
+        blitImage(display, x, y, *source, color);
+        markDirty(display, x, y, source->width, source->height);
+        break;
+      }
+
+      case SCENE_SCROLL: {
+        ImageSource* source = nextImage();
+        uint16_t initialdelay = nextWord();
+        uint16_t enddelay = nextWord();
+        uint16_t scrolldelay = nextWord();
+        int8_t scrollstep = next();
+        uint8_t flags = next();
+        int16_t x = nextWord();
+        int16_t y = nextWord();
+        int16_t end_y = nextWord();
+        if (!source) break;
+        scroll.begin(display, initialdelay, enddelay, scrolldelay, scrollstep, flags & SCENE_SNAP_TO_END, flags & SCENE_ALLOW_OVERFLOW, x, y, end_y, *source);
+        return play(scroll);
+      }
+
+      case SCENE_WAIT:
+        return nextWord();
+
+      case SCENE_JUMP:
+        pos = nextWord();
+        break;
+
+      case SCENE_CHOICE: {
+        uint8_t button = next();
+        uint8_t nextbutton = next();
+        uint8_t count = next();
+
+        // The options are packed one after the other into `text`, cut to what fits
+        uint16_t used = 0;
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < count; i++) {
+          char* option = text + used;
+          nextString(option, sizeof(text) - used);
+          uint16_t target = nextWord();
+          if (kept < SSD1306FUNC_SCENE_CHOICES) {
+            choices[kept] = option;
+            targets[kept++] = target;
+          }
+          used += strlen(option) + 1;
+          if (used > sizeof(text) - 1) used = sizeof(text) - 1;
+        }
+        if (!kept) break;
+        choice.begin(display, button, nextbutton, choices, kept);
+        return play(choice);
+      }
+
+      default:                            // `SCENE_END`, or a byte that is no opcode
+        return EFFECT_DONE;
+    }
+  }
+}
+
+/// @brief Plays a scene script, e.g. one written by `tools/ssd1306scene.py`. A scene in data takes far less flash than the same calls in code, and can be changed without touching the sketch.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param script The script, in PROGMEM.
+/// @param images The images the script refers to by number. They have to outlive the scene.
+/// @param imagecount Number of entries in `images`. Image opcodes with a number past the end are skipped.
+void playScene(Adafruit_SSD1306* display, const uint8_t* script, ImageSource** images, uint8_t imagecount) {
+  SceneEffect effect;
+  effect.begin(display, script, images, imagecount);
+  runEffect(effect);
+}
+
+/// @brief Plays a scene script read through `reader`, e.g. a file on an SD card, so scenes can change without reflashing.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param reader Called to read the script bytes, a few at a time. It may be asked for bytes past the end of the script, which are not used.
+/// @param context Passed to `reader`, e.g. the open file.
+/// @param images The images the script refers to by number. They have to outlive the scene.
+/// @param imagecount Number of entries in `images`. Image opcodes with a number past the end are skipped.
+void playScene(Adafruit_SSD1306* display, ImageReader reader, void* context, ImageSource** images, uint8_t imagecount) {
+  SceneEffect effect;
+  effect.begin(display, reader, context, images, imagecount);
+  runEffect(effect);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// PAGE MODE FUNCTIONS
+
+// Page mode draws the screen one page at a time into this strip and sends each page as soon as it is drawn, so the
+// 1 KB framebuffer can be freed with `releaseFramebuffer()`. Everything on screen is drawn again for every page.
+static uint8_t pageStrip[SSD1306FUNC_MAX_COLUMNS];
+
+/// @brief Frees the framebuffer `begin()` allocated, for displays that are only drawn with `renderPages()` from then on. Nothing may draw into the framebuffer or flush it afterwards; calling `begin()` again allocates a new one.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object, after `begin()`.
+void releaseFramebuffer(Adafruit_SSD1306* display) {
+  finishFlush(display);
+  free(display->*SSD1306Members::bufferMember);
+  display->*SSD1306Members::bufferMember = NULL;
+}
+
+/// @brief Draws the whole screen a page at a time, without the framebuffer. `renderer` fills each page strip, which is sent before the next page is drawn.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object. Needs hardware I2C or SPI, and no rotation.
+/// @param renderer Called once per page, top to bottom, with a cleared strip of one byte per column.
+/// @param context Passed to `renderer`.
+void renderPages(Adafruit_SSD1306* display, PageRenderer renderer, void* context) {
+  if (!hasBus(display)) return;
+  finishFlush(display);
+
+  uint8_t width = getPanelWidth(display);
+  uint8_t pages = getPageCount(display);
+  if (width > sizeof(pageStrip)) return;
+
+  openWindow(display, 0, width - 1, 0, pages - 1);
+  for (uint8_t page = 0; page < pages; page++) {
+    memset(pageStrip, 0, width);
+    renderer(display, page, pageStrip, context);
+    sendData(display, pageStrip, width);
+  }
+}
+
+/// @brief Draws the part of a bitmap that falls on one page strip, like `blitImage` does with the framebuffer.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param page The page the strip holds, as passed to the `PageRenderer`.
+/// @param strip The page strip, as passed to the `PageRenderer`.
+/// @param x The x-coordinate of the image, starting at top-left.
+/// @param y The y-coordinate of the image, starting at top-left.
+/// @param source Where the bitmap rows are read from. Only the rows on this page are read.
+/// @param color Either `0` (off), `1` (on), or `2` (inverse).
+void blitImageToPage(Adafruit_SSD1306* display, uint8_t page, uint8_t* strip, int16_t x, int16_t y, ImageSource& source, uint16_t color) {
+  blitPages(display, strip, page, page, 0, display->width(), x, y, &source, color);
+}
+
+/// @brief Draws the part of a text that falls on one page strip, in the built-in font at size 1 or the `setGlyphFont()` font, and the display's text colors. `\n` starts a new line at `x`, 8 pixels down.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param page The page the strip holds, as passed to the `PageRenderer`.
+/// @param strip The page strip, as passed to the `PageRenderer`.
+/// @param x The x-coordinate of the text, starting at top-left.
+/// @param y The y-coordinate of the text, starting at top-left. Need not be page-aligned.
+/// @param text The text to draw.
+void writeTextToPage(Adafruit_SSD1306* display, uint8_t page, uint8_t* strip, int16_t x, int16_t y, const char* text) {
+  const GlyphFont* font = getGlyphFont(display);
+  uint16_t color = display->*SSD1306Members::textcolorMember;
+  uint16_t bg = display->*SSD1306Members::textbgcolorMember;
+  bool opaque = bg != color;
+  int16_t width = getPanelWidth(display);
+  int16_t startx = x;
+
+  for (; *text; text++) {
+    char c = *text;
+    if (c == '\n') {
+      x = startx;
+      y += 8;
+      continue;
+    }
+    if (c == '\r') continue;
+
+    uint8_t glyphwidth = 5, advance = 6;
+    if (font) {
+      if ((uint8_t) c < font->first || (uint8_t) c > font->last) continue;
+      glyphwidth = font->width;
+      advance = font->advance;
+    }
+
+    if (display->*SSD1306Members::wrapMember && x + advance > width) {
+      x = 0;
+      y += 8;
+    }
+
+    // The glyph's rows on this page: its columns shifted down (or up) by how far the text line sits from the page top
+    int16_t shift = y - page * 8;
+    if (shift > -8 && shift < 8 && x + advance > 0 && x < width) {
+      const uint8_t* columns = font ? font->columns + ((uint8_t) c - font->first) * glyphwidth : getBuiltinGlyph(display, c);
+      uint8_t cover = shift >= 0 ? 0xFF << shift : 0xFF >> -shift;
+
+      for (uint8_t i = 0; i < advance; i++) {
+        int16_t col = x + i;
+        if (col < 0 || col >= width) continue;
+
+        uint8_t bits = i >= glyphwidth ? 0 : font ? pgm_read_byte(columns + i) : columns[i];
+        bits = shift >= 0 ? bits << shift : bits >> -shift;
+        if (opaque) strip[col] = (strip[col] & ~cover) | ((color ? bits : ~bits) & cover);
+        else applyByte(strip + col, bits, color);
+      }
+    }
+    x += advance;
+  }
+}
+
+/// @brief Turns the pixels of one step of a mask on or off in one page strip, like each frame of `fadeMask` does with the framebuffer.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param page The page the strip holds, as passed to the `PageRenderer`.
+/// @param strip The page strip, as passed to the `PageRenderer`.
+/// @param mask Which pixels each step covers.
+/// @param step The step of `mask` to apply.
+/// @param color Either `0` (off) or `1` (on).
+void applyMaskToPage(Adafruit_SSD1306* display, uint8_t page, uint8_t* strip, FadeMask mask, uint16_t step, uint16_t color) {
+  maskPages(display, strip, page, page, mask, step, color);
+}
+
+/// @brief Starts a non-blocking `fadePages`. Call `tick()` until it returns `false`.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param renderer Draws the screen being faded, a page at a time. It is called again for every step.
+/// @param context Passed to `renderer`.
+/// @param mask Which pixels each step covers.
+/// @param stepdelay Number of milliseconds taken per step.
+/// @param state The state of the pixels set by the effect, either `0` (off) or `1` (on).
+void PageFadeEffect::begin(Adafruit_SSD1306* display, PageRenderer renderer, void* context, FadeMask mask, long stepdelay, uint16_t state) {
+  this->renderer = renderer;
+  this->context = context;
+  this->mask = mask;
+  this->stepdelay = stepdelay;
+  this->state = state;
+  start(display);
+}
+
+// Draws a page of the faded screen: the renderer's page, with every mask step up to the current frame applied on top.
+void PageFadeEffect::renderPage(Adafruit_SSD1306* display, uint8_t page, uint8_t* strip, void* context) {
+  PageFadeEffect* effect = (PageFadeEffect*) context;
+  if (effect->frame >= effect->mask.steps) return;   // The cleared screen that ends a fade-out
+
+  effect->renderer(display, page, strip, effect->context);
+  for (uint16_t step = 0; step <= effect->frame; step++) applyMaskToPage(display, page, strip, effect->mask, step, effect->state);
+}
+
+// Same frames as `FadeEffect`, drawn and sent whole by `renderPages()`, so the engine has nothing left to flush.
+long PageFadeEffect::step() {
+  if (frame < mask.steps || (frame == mask.steps && !state)) {
+    renderPages(display, renderPage, this);
+    return stepdelay;
+  }
+
+  return EFFECT_DONE;
+}
+
+/// @brief Fades a screen drawn by `renderer` into white or black, step by step, without the framebuffer.
+/// @param display A pointer pointing to the `Adafruit_SSD1306` display object.
+/// @param renderer Draws the screen being faded, a page at a time. It is called again for every step.
+/// @param context Passed to `renderer`.
+/// @param mask Which pixels each step covers, e.g. `{NULL, 4, 1, 0}` for `fadeVertical`'s pattern at 4 cycles.
+/// @param stepdelay Number of milliseconds taken per step.
+/// @param state The state of the pixels set by the effect, either `0` (off) or `1` (on).
+void fadePages(Adafruit_SSD1306* display, PageRenderer renderer, void* context, FadeMask mask, long stepdelay, uint16_t state) {
+  PageFadeEffect effect;
+  effect.begin(display, renderer, context, mask, stepdelay, state);
+  runEffect(effect);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// EXPERIMENTAL
+
+// CTC functions that use GPIO inputs instead of serial monitor for user input
+
+/// @brief Use a GPIO button to wait for a user input. Displays a CTC indicator at the bottom-right corner.
+/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
+/// @param button The GPIO pin of the button, read as pressed while `HIGH`.
+void ctc(Adafruit_SSD1306* display, uint8_t button) {
+  CtcEffect effect;
+  effect.begin(display, button, false, 0);
+  runEffect(effect);
+}
+
+/// @brief Use a GPIO button to wait for a user input, or use a timer. Displays a CTC indicator at the bottom-right corner.
+/// @param display A pointer pointing to the Adafruit_SSD1306 display object.
+/// @param button The GPIO pin of the button, read as pressed while `HIGH`.
+/// @param timerMS CTC timer, in milliseconds.
+void ctcTimed(Adafruit_SSD1306* display, uint8_t button, long timerMS) {
+  CtcEffect effect;
+  effect.begin(display, button, true, timerMS);
+  runEffect(effect);
+}
@@ -17,16 +17,309 @@ typedef struct ImageByteArray {
 } Image;
 
 
+// Which pixels each step of a mask fade covers, repeated over the whole screen. Either `tiles` points to `steps` 8x8 tiles in PROGMEM,
+// 8 bytes each (one per column, top pixel in bit 0), or it is `NULL` and step s covers the pixels where (dx * x + dy * y) % steps == s.
+typedef struct FadeMaskPattern {
+  const uint8_t* PROGMEM tiles;     // The per-step tiles, or `NULL` for a line pattern.
+  uint16_t steps;                   // Number of steps in the fade.
+  int8_t dx, dy;                    // Line patterns only: either `-1`, `0` or `1`.
+} FadeMask;
+
+// One frame of an animation played by `playAnimation`. Written by `tools/ssd1306img.py --format delta`, which also writes the array.
+typedef struct AnimationFrameRecord {
+  const uint8_t* PROGMEM delta;     // What changed since the previous frame, as bytes XORed into the framebuffer.
+  uint16_t duration;                // How long the frame stays on screen, in milliseconds.
+} AnimationFrame;
+
+// A compact 8-pixel-high font for `setGlyphFont()`, written by `tools/ssd1306img.py --format font`. Glyphs `first` to `last`
+// are stored one after the other, `width` column bytes each, top pixel in bit 0.
+typedef struct GlyphFontRecord {
+  const uint8_t* PROGMEM columns;   // The glyph columns, `width` bytes per character.
+  uint8_t first, last;              // The first and last character in the font.
+  uint8_t width;                    // Columns per glyph.
+  uint8_t advance;                  // How far the cursor moves per character, in pixels: at least `width`.
+} GlyphFont;
+
+// A grayscale bitmap in PROGMEM, written by `tools/ssd1306img.py --format gray`: rows of `(width * bits + 7) / 8` bytes, each
+// pixel `bits` wide and MSB first, from `0` (off) up to `(1 << bits) - 1` (fully on).
+typedef struct GrayImageRecord {
+  const uint8_t* PROGMEM pixels;    // The packed pixel levels.
+  const int width;                  // Width of the image, in pixels.
+  const int height;                 // Height of the image, in pixels.
+  const uint8_t bits;               // Bits per pixel: `2` or `4`.
+} GrayImage;
+
+// A point on a `panImage` path: the image pixel shown at the top-left of the screen, and how long the pan there takes.
+typedef struct PanPointRecord {
+  int16_t x, y;                     // Top-left of the view, in image pixels. The view may go past the image's edges, which show blank.
+  uint16_t duration;                // Milliseconds taken to get here from the previous point. Ignored for the first point.
+} PanPoint;
+
+
+// Reads `count` bytes at `offset` of a stored bitmap into `dest`, e.g. from a file on an SD card or from SPI flash.
+typedef void (*ImageReader)(void* context, uint32_t offset, uint8_t* dest, uint16_t count);
+
+// Where the rows of a bitmap come from. Drawing functions fetch only the rows and bytes that land on the screen, so the
+// bitmap itself never has to fit in RAM. The layout is the same as an `Image`: rows of `(width + 7) / 8` bytes, MSB first.
+class ImageSource {
+  public:
+    ImageSource(int, int);
+    virtual void read(int16_t, uint8_t, int16_t, uint8_t, uint8_t*) = 0;  // Copies `count` rows from `row`, bytes `firstbyte` onward, `bytes` per row.
+    virtual const uint8_t* getPages();    // The bitmap in PROGMEM in the SSD1306 page layout, if it is stored that way, or `NULL`.
+
+    int width;                        // Width of the image, in pixels.
+    int height;                       // Height of the image, in pixels.
+};
+
+// A bitmap stored in PROGMEM, like the ones `Image` points to.
+class ProgmemImageSource : public ImageSource {
+  public:
+    ProgmemImageSource(const uint8_t* = NULL, int = 0, int = 0);
+    ProgmemImageSource(Image);
+    void read(int16_t, uint8_t, int16_t, uint8_t, uint8_t*);
+  protected:
+    const uint8_t* bitmap;
+};
+
+// A bitmap in RAM, e.g. one drawn at runtime.
+class RamImageSource : public ImageSource {
+  public:
+    RamImageSource(const uint8_t*, int, int);
+    void read(int16_t, uint8_t, int16_t, uint8_t, uint8_t*);
+  protected:
+    const uint8_t* bitmap;
+};
+
+// A bitmap read through an `ImageReader` callback, starting `offset` bytes into whatever the reader reads from.
+class StreamImageSource : public ImageSource {
+  public:
+    StreamImageSource(ImageReader, void*, int, int, uint32_t = 0);
+    void read(int16_t, uint8_t, int16_t, uint8_t, uint8_t*);
+  protected:
+    ImageReader reader;
+    void* context;
+    uint32_t offset;
+};
+
+// A bitmap in PROGMEM compressed by `tools/ssd1306img.py --format rle`: a little-endian `uint16_t` offset per 8-row band,
+// then each band as PackBits runs over its byte columns, 8 rows per column. Bands are decoded as they are read, so drawing
+// needs no decompression buffer, and art that repeats down a band compresses as well as art that repeats across.
+class RleImageSource : public ImageSource {
+  public:
+    RleImageSource(const uint8_t*, int, int);
+    void read(int16_t, uint8_t, int16_t, uint8_t, uint8_t*);
+  protected:
+    const uint8_t* data;
+};
+
+// A bitmap in PROGMEM split by `tools/ssd1306img.py --format tiles` into 8x8 tiles, stored once each: a tile number per
+// 8-row band and byte column, then the tiles, 8 row bytes each. Suits UI art that repeats borders, fills and patterns.
+class TileImageSource : public ImageSource {
+  public:
+    TileImageSource(const uint8_t*, int, int);
+    void read(int16_t, uint8_t, int16_t, uint8_t, uint8_t*);
+  protected:
+    const uint8_t* data;
+};
+
+// A bitmap in PROGMEM in the SSD1306's own page layout, written by `tools/ssd1306img.py --format pages`: `(height + 7) / 8`
+// pages of `width` column bytes, top pixel in bit 0. Unrotated draws copy its bytes into the framebuffer pages as they are,
+// with no transposing; reading it as rows still works for everything else.
+class PageImageSource : public ImageSource {
+  public:
+    PageImageSource(const uint8_t*, int, int);
+    void read(int16_t, uint8_t, int16_t, uint8_t, uint8_t*);
+    const uint8_t* getPages();
+  protected:
+    const uint8_t* data;
+};
+
+
+// Number of displays whose dirty pages can be tracked at the same time. Displays beyond this fall back to full flushes.
+#ifndef SSD1306FUNC_MAX_DISPLAYS
+#define SSD1306FUNC_MAX_DISPLAYS 2
+#endif
+
+// Size of the unrotated panel, when every display the sketch drives has the same one: e.g. `128` and `32`, `96` and `16`,
+// or `64` and `48`. Page counts, loop bounds and the tracking tables then become compile-time constants. Leave at `0` to
+// read the size from each display at runtime.
+#ifndef SSD1306FUNC_WIDTH
+#define SSD1306FUNC_WIDTH 0
+#endif
+#ifndef SSD1306FUNC_HEIGHT
+#define SSD1306FUNC_HEIGHT 0
+#endif
+
+// GDDRAM column the panel's first column is wired to. Negative values use the usual wiring: `32` on 64-pixel-wide panels,
+// which sit in the middle of the controller's 128 columns, and `0` otherwise.
+#ifndef SSD1306FUNC_COLUMN_OFFSET
+#define SSD1306FUNC_COLUMN_OFFSET -1
+#endif
+
+// Size of the controller's display RAM (GDDRAM), of which the panel shows a window: 128 columns by 64 rows, in 8-row pages.
+#define SSD1306_GDDRAM_COLUMNS 128
+#define SSD1306_GDDRAM_ROWS 64
+
+// Largest number of 8-row pages tracked per display: all 8 of GDDRAM, or just the pages of `SSD1306FUNC_HEIGHT` when it is set.
+#if SSD1306FUNC_HEIGHT
+#define SSD1306FUNC_MAX_PAGES ((SSD1306FUNC_HEIGHT + 7) / 8)
+#else
+#define SSD1306FUNC_MAX_PAGES (SSD1306_GDDRAM_ROWS / 8)
+#endif
+
+// Largest number of columns in a page: all 128 of GDDRAM, or just `SSD1306FUNC_WIDTH` when it is set. Sizes the one-page buffers.
+#if SSD1306FUNC_WIDTH
+#define SSD1306FUNC_MAX_COLUMNS SSD1306FUNC_WIDTH
+#else
+#define SSD1306FUNC_MAX_COLUMNS SSD1306_GDDRAM_COLUMNS
+#endif
+
+// Set to `1` to give each tracked display a second framebuffer. Effects then copy each frame's changes into it and send them from
+// there in small chunks while waiting for the next frame, so bus time overlaps the effect's delays and the drawing of the next
+// frame instead of adding to them. Costs one more framebuffer of RAM per display. Call `finishFlush()` before talking to the
+// display directly, e.g. through `display->display()`.
+#ifndef SSD1306FUNC_ASYNC_FLUSH
+#define SSD1306FUNC_ASYNC_FLUSH 0
+#endif
+
+// Set to `1` to let scene scripts draw ahead while a CTC waits: the clears, header labels and images that follow it are drawn
+// into a second framebuffer during the wait, and only copied in and flushed once it ends. Costs one more framebuffer of RAM per
+// display, allocated by the first scene that uses it.
+#ifndef SSD1306FUNC_SCENE_PREFETCH
+#define SSD1306FUNC_SCENE_PREFETCH 0
+#endif
+
+// Set to `1` to record frame timing and bus traffic for every effect run. See `EffectStats`.
+#ifndef SSD1306FUNC_STATS
+#define SSD1306FUNC_STATS 0
+#endif
+
+// Milliseconds a GPIO button has to hold its level before a CTC wait takes it as pressed or released.
+#ifndef SSD1306FUNC_DEBOUNCE_MS
+#define SSD1306FUNC_DEBOUNCE_MS 20
+#endif
+
+// `runEffect()` and the blocking functions idle the MCU until the next interrupt (at most about a millisecond, from the
+// `millis()` timer) whenever nothing is being sent, which is most of the time during a CTC or choice wait. Idle sleep keeps
+// timers, serial and pin interrupts running. It is on by default on the cores whose timer tick wakes the MCU: AVR, SAMD,
+// STM32, Teensy and the ESP cores. Set to `0` to only yield between frames, e.g. on a core whose tick is stopped in sleep.
+#ifndef SSD1306FUNC_SLEEP
+#if defined(__AVR__) || defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_ARCH_STM32) || defined(TEENSYDUINO) || defined(ESP32) || defined(ESP8266)
+#define SSD1306FUNC_SLEEP 1
+#else
+#define SSD1306FUNC_SLEEP 0
+#endif
+#endif
+
+// Set to `1` on a dual-core ESP32 to let `runEffects()` run the effects on another bus than the first effect's on the other
+// core, so two I2C or SPI buses are driven at the same time. Effects sharing a bus always stay on the same core.
+#ifndef SSD1306FUNC_DUAL_CORE
+#define SSD1306FUNC_DUAL_CORE 0
+#endif
+#if SSD1306FUNC_DUAL_CORE && !defined(ESP32)
+#error "SSD1306FUNC_DUAL_CORE needs a dual-core ESP32"
+#endif
+
+// Stack size, in bytes, of the task `runEffects()` starts on the other core.
+#ifndef SSD1306FUNC_TASK_STACK
+#define SSD1306FUNC_TASK_STACK 4096
+#endif
+
+// Number of built-in font glyphs kept as ready-made page bytes for the fast text path, 6 bytes each.
+#ifndef SSD1306FUNC_GLYPH_CACHE
+#define SSD1306FUNC_GLYPH_CACHE 32
+#endif
+
+// Number of dialog lines laid out at a time. Longer dialogs are laid out again, a table at a time, as the reveal reaches them.
+#ifndef SSD1306FUNC_DIALOG_LINES
+#define SSD1306FUNC_DIALOG_LINES 8
+#endif
+
+// Longest header label and dialog text, in characters, a scene script can show. Texts are copied into RAM for the dialog.
+#ifndef SSD1306FUNC_SCENE_HEADER
+#define SSD1306FUNC_SCENE_HEADER 21
+#endif
+#ifndef SSD1306FUNC_SCENE_TEXT
+#define SSD1306FUNC_SCENE_TEXT 160
+#endif
+
+// Most options a scene script's choice menu can offer. Their texts share the dialog text's RAM.
+#ifndef SSD1306FUNC_SCENE_CHOICES
+#define SSD1306FUNC_SCENE_CHOICES 6
+#endif
+
+// Selects a display's channel before the library talks to it, e.g. by writing `1 << channel` to a TCA9548A. See `setDisplaySelect()`.
+typedef void (*DisplaySelect)(uint8_t channel);
+
+// Draws one page of the screen into `strip`, one byte per column with the top pixel in bit 0. See `renderPages()`.
+typedef void (*PageRenderer)(Adafruit_SSD1306* display, uint8_t page, uint8_t* strip, void* context);
+
+// Returns `true` while its confirm input is active, e.g. a touch pad or a radio message. See `setConfirmCallback()`.
+typedef bool (*ConfirmCallback)();
+
+#if SSD1306FUNC_STATS
+// What one effect run cost. Drawing plus flushing plus idle waiting adds up to `actualMillis`.
+typedef struct EffectStatsRecord {
+  uint16_t frames;                  // Number of frames drawn.
+  uint16_t mergedFrames;            // Frames that were already late, and so were flushed together with the next one.
+  unsigned long drawMicros;         // Time spent drawing frames into the framebuffer.
+  unsigned long flushMicros;        // Time spent sending frames to the display.
+  unsigned long bytes;              // Command and data bytes sent to the controller, not counting I2C address and control bytes.
+  unsigned long requestedMillis;    // Sum of the delays the effect asked for between frames.
+  unsigned long actualMillis;       // Time from the first frame until the effect finished.
+} EffectStats;
+#endif
+
+
+void markDirty(Adafruit_SSD1306*, int16_t, int16_t, int16_t, int16_t);
+bool isDirty(Adafruit_SSD1306*);
+void flushDirty(Adafruit_SSD1306*);
+void flushScreen(Adafruit_SSD1306*);
+void flushWindow(Adafruit_SSD1306*, uint8_t, uint8_t, uint8_t, uint8_t);
+void startFlush(Adafruit_SSD1306*);
+bool pumpFlush(Adafruit_SSD1306*);
+void finishFlush(Adafruit_SSD1306*);
+void setDisplaySelect(Adafruit_SSD1306*, DisplaySelect, uint8_t);
+uint32_t setBusClock(Adafruit_SSD1306*, uint32_t);
+
+void writeText(Adafruit_SSD1306*, const char*);
+void setGlyphFont(Adafruit_SSD1306*, const GlyphFont*);
+
 void fillScreenSlow(Adafruit_SSD1306*);
 void fillScreenFast(Adafruit_SSD1306*);
+uint32_t getFramebufferCrc(Adafruit_SSD1306*);
 void fadeGrid(Adafruit_SSD1306*, long, uint16_t);
 void fadeCross(Adafruit_SSD1306*, long, uint16_t);
 void fadeVertical(Adafruit_SSD1306*, int, long, uint16_t);
 void fadeHorizontal(Adafruit_SSD1306*, int, long, uint16_t);
 void fadeDiagonal(Adafruit_SSD1306*, int, long, uint16_t);
+void fadeDissolve(Adafruit_SSD1306*, long, uint16_t);
+void fadeMask(Adafruit_SSD1306*, FadeMask, long, uint16_t);
 
+void blitImage(Adafruit_SSD1306*, int16_t, int16_t, Image, uint16_t);
+void blitImage(Adafruit_SSD1306*, int16_t, int16_t, ImageSource&, uint16_t);
 void fadeInGridBitmap(Adafruit_SSD1306*, long, long, int16_t, int16_t, Image);
+void fadeInGridBitmap(Adafruit_SSD1306*, long, long, int16_t, int16_t, ImageSource&);
+void crossFadeImages(Adafruit_SSD1306*, FadeMask, long, int16_t, int16_t, Image, Image);
+void crossFadeImages(Adafruit_SSD1306*, FadeMask, long, int16_t, int16_t, ImageSource&, ImageSource&);
 void drawVerticalScrollingBitmap(Adafruit_SSD1306*, long, long, long, int, bool, bool, int16_t, int16_t, int16_t, Image);
+void drawVerticalScrollingBitmap(Adafruit_SSD1306*, long, long, long, int, bool, bool, int16_t, int16_t, int16_t, ImageSource&);
+void drawHardwareScrollingBitmap(Adafruit_SSD1306*, long, long, long, int, int16_t, int16_t, Image);
+void drawHardwareScrollingBitmap(Adafruit_SSD1306*, long, long, long, int, int16_t, int16_t, ImageSource&);
+void panImage(Adafruit_SSD1306*, long, uint8_t, const PanPoint*, uint8_t, Image);
+void panImage(Adafruit_SSD1306*, long, uint8_t, const PanPoint*, uint8_t, ImageSource&);
+void drawDitheredImage(Adafruit_SSD1306*, int16_t, int16_t, GrayImage);
+void drawGrayscaleImage(Adafruit_SSD1306*, long, long, bool, int16_t, int16_t, GrayImage);
+void playAnimation(Adafruit_SSD1306*, const AnimationFrame*, uint16_t, int16_t, uint16_t);
+void playAnimation(Adafruit_SSD1306*, const Image*, uint16_t, long, int16_t, int16_t, int16_t);
+
+void fillRegion(Adafruit_SSD1306*, int16_t, int16_t, int16_t, int16_t, uint16_t);
+void clearRegion(Adafruit_SSD1306*, int16_t, int16_t, int16_t, int16_t);
+void invertRegion(Adafruit_SSD1306*, int16_t, int16_t, int16_t, int16_t);
+uint16_t getRegionSize(Adafruit_SSD1306*, int16_t, int16_t, int16_t, int16_t);
+void saveRegion(Adafruit_SSD1306*, int16_t, int16_t, int16_t, int16_t, uint8_t*);
+void restoreRegion(Adafruit_SSD1306*, int16_t, int16_t, int16_t, int16_t, const uint8_t*);
+void flushRegion(Adafruit_SSD1306*, int16_t, int16_t, int16_t, int16_t);
 
 void drawDialogText(Adafruit_SSD1306*, uint8_t, long, long, uint8_t, const char*, const char*);
 void drawTimedDialogText(Adafruit_SSD1306*, uint8_t, long, long, long, uint8_t, uint8_t, uint8_t, const char*, const char*);
@@ -37,6 +330,425 @@ void ctcSerial(Adafruit_SSD1306*);
 void ctcTimedSerial(Adafruit_SSD1306*, long);
 void ctc(Adafruit_SSD1306*, uint8_t);
 void ctcTimed(Adafruit_SSD1306*, uint8_t, long);
+void setConfirmCallback(ConfirmCallback);
+uint8_t drawChoiceMenu(Adafruit_SSD1306*, uint8_t, uint8_t, const char* const*, uint8_t);
+
+
+// Returned by `SSD1306Effect::step()` once the effect has no frames left.
+#define EFFECT_DONE -1
+
+// Pass as the button pin to `CtcEffect::begin()` to wait on the serial monitor instead of a GPIO input.
+#define CTC_SERIAL 0xFF
+
+
+// Base of the non-blocking effects. `begin()` stores the parameters, then each `tick()` draws a frame once its deadline is reached.
+class SSD1306Effect {
+  public:
+    SSD1306Effect();
+    bool tick(unsigned long);
+    bool isRunning();
+    virtual bool isWaiting();
+    void stop();
+    void idle();
+    Adafruit_SSD1306* getDisplay();
+#if SSD1306FUNC_STATS
+    EffectStats getStats();
+#endif
+
+  protected:
+    void start(Adafruit_SSD1306*);
+    virtual long step() = 0;              // Draws the current frame, returning the delay before the next one or `EFFECT_DONE`.
+
+    Adafruit_SSD1306* display;
+    uint16_t frame;                       // Number of frames drawn so far.
+    unsigned long deadline;               // `millis()` value at which the next frame is due, advanced by each wait.
+    bool running;
+
+#if SSD1306FUNC_STATS
+    void finishStats();
+
+    EffectStats stats;
+    unsigned long startmillis;            // `millis()` value when the effect started.
+    unsigned long startbytes;             // The display's bus byte count when the effect started.
+#endif
+};
+
+class FadeEffect : public SSD1306Effect {
+  protected:
+    void startFade(Adafruit_SSD1306*, FadeMask, long, uint16_t);
+    long step();
+
+    FadeMask mask;
+    long stepdelay;
+    uint16_t state;
+};
+
+class FadeGridEffect : public FadeEffect {
+  public:
+    void begin(Adafruit_SSD1306*, long, uint16_t);
+};
+
+class FadeCrossEffect : public FadeEffect {
+  public:
+    void begin(Adafruit_SSD1306*, long, uint16_t);
+};
+
+class FadeVerticalEffect : public FadeEffect {
+  public:
+    void begin(Adafruit_SSD1306*, int, long, uint16_t);
+};
+
+class FadeHorizontalEffect : public FadeEffect {
+  public:
+    void begin(Adafruit_SSD1306*, int, long, uint16_t);
+};
+
+class FadeDiagonalEffect : public FadeEffect {
+  public:
+    void begin(Adafruit_SSD1306*, int, long, uint16_t);
+};
+
+class FadeDissolveEffect : public FadeEffect {
+  public:
+    void begin(Adafruit_SSD1306*, long, uint16_t);
+};
+
+class MaskFadeEffect : public FadeEffect {
+  public:
+    void begin(Adafruit_SSD1306*, FadeMask, long, uint16_t);
+};
+
+class FadeInGridBitmapEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, long, long, int16_t, int16_t, Image);
+    void begin(Adafruit_SSD1306*, long, long, int16_t, int16_t, ImageSource&);
+  protected:
+    long step();
+
+    long delaytime, initdelaytime;
+    int16_t offset_x, offset_y;
+    ProgmemImageSource image;
+    ImageSource* source;
+};
+
+// Changes one image into another a mask step at a time: each step shows `to` in the pixels of that step, over `from` in the
+// rest, without a white screen in between. Only the columns of each page that change are flushed.
+class CrossFadeEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, FadeMask, long, int16_t, int16_t, Image, Image);
+    void begin(Adafruit_SSD1306*, FadeMask, long, int16_t, int16_t, ImageSource&, ImageSource&);
+  protected:
+    long step();
+    bool compose(ImageSource*, const FadeMask*, uint16_t);
+
+    FadeMask mask;
+    long stepdelay;
+    int16_t offset_x, offset_y;
+    int16_t width, height;                // Both images together, from the offset.
+    uint16_t maskstep;                    // Next step of `mask` to show `to` in.
+    ProgmemImageSource fromimage, toimage;
+    ImageSource* from;
+    ImageSource* to;
+};
+
+class VerticalScrollEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, long, long, long, int, bool, bool, int16_t, int16_t, int16_t, Image);
+    void begin(Adafruit_SSD1306*, long, long, long, int, bool, bool, int16_t, int16_t, int16_t, ImageSource&);
+  protected:
+    long step();
+    void drawAt(int16_t, uint16_t);
+    void moveTo(int16_t);
+
+    long initialdelay, enddelay, scrolldelay;
+    int scrollstep;
+    bool snaptoend, finished;
+    int16_t offset_x, offset_y, end_y;
+    int16_t drawn_y;                      // Where the bitmap is currently drawn.
+    int position;                         // Scroll position: rows scrolled for scroll-down, current y for scroll-up.
+    ProgmemImageSource image;             // Holds an `Image` passed to `begin()`, so `source` can point at it.
+    ImageSource* source;
+};
+
+// Easing of each leg of a `panImage` path.
+#define PAN_LINEAR 0
+#define PAN_EASE_IN 1
+#define PAN_EASE_OUT 2
+#define PAN_EASE_IN_OUT 3
+
+class HardwareScrollEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, long, long, long, int, int16_t, int16_t, Image);
+    void begin(Adafruit_SSD1306*, long, long, long, int, int16_t, int16_t, ImageSource&);
+  protected:
+    long step();
+    void setStartLine(int16_t);
+    void writePage(uint8_t);
+    void moveTo(int16_t);
+    void restoreLayout();
+
+    long initialdelay, enddelay, scrolldelay;
+    int scrollstep;
+    bool hardware, finished;
+    int16_t offset_x;
+    int16_t position, endposition;        // Image row shown at the top of the screen, now and when scrolling stops.
+    int16_t base, margin;                 // First image row held in GDDRAM, and how many rows it keeps above the screen.
+    ProgmemImageSource image;
+    ImageSource* source;
+};
+
+class PanEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, long, uint8_t, const PanPoint*, uint8_t, Image);
+    void begin(Adafruit_SSD1306*, long, uint8_t, const PanPoint*, uint8_t, ImageSource&);
+  protected:
+    long step();
+    void drawView();
+    void moveTo(int16_t, int16_t);
+
+    long framedelay;
+    uint8_t easing;
+    const PanPoint* path;
+    uint8_t count, point;                 // Number of points, and the one the current leg leads to.
+    uint16_t legframe, legframes;         // Frames of the current leg drawn so far, and in total.
+    int16_t view_x, view_y;               // Image pixel currently shown at the top-left of the screen.
+    ProgmemImageSource image;
+    ImageSource* source;
+};
+
+class GrayscaleEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, long, long, bool, int16_t, int16_t, GrayImage);
+  protected:
+    long step();
+
+    long duration, framedelay;
+    bool contrast;                        // Weighted bit-planes at matching contrast levels, instead of one frame per level.
+    int16_t offset_x, offset_y;
+    const uint8_t* pixels;
+    int16_t width, height;
+    uint8_t bits;
+    unsigned long startmillis;
+};
+
+class AnimationEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, const AnimationFrame*, uint16_t, int16_t, uint16_t);
+    void begin(Adafruit_SSD1306*, const Image*, uint16_t, long, int16_t, int16_t, int16_t);
+  protected:
+    long step();
+
+    const AnimationFrame* deltas;         // The delta frames, or `NULL` when playing `images`.
+    const Image* images;
+    uint16_t count, index, loopframe;
+    int16_t loops;                        // Repeats left, or negative to repeat forever.
+    int16_t previous;                     // Image frame currently drawn, or `-1`.
+    long framedelay;
+    int16_t offset_x, offset_y;
+};
+
+class CtcEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, uint8_t, bool, long);
+    bool isWaiting();
+  protected:
+    long step();
+    void renderIndicator();
+    void copyIndicator(uint8_t*, bool);
+    void showIndicator(uint8_t);
+
+    uint8_t button;
+    bool timed, released;
+    bool level;                           // Last level read from `button`, held since `changed`.
+    long timerMS;
+    unsigned long basetime, blinkat, changed;
+    int baseX, baseY;
+    uint8_t color;
+    uint8_t indicator[2][16];             // Panel bytes under the indicator, hidden and shown.
+    uint8_t indicatorcol, indicatorcols, indicatorpage, indicatorpages;
+};
+
+// One line of a laid-out dialog: the characters from `start` up to, not including, `end`.
+typedef struct DialogLineRecord {
+  uint16_t start, end;
+} DialogLine;
+
+class DialogTextEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, uint8_t, long, long, long, uint8_t, uint8_t, uint8_t, const char*, const char*);
+    bool isWaiting();
+  protected:
+    enum { DIALOG_HEADER, DIALOG_INSTANT, DIALOG_TEXT, DIALOG_CTC_PENDING, DIALOG_CTC, DIALOG_PAGE_PENDING, DIALOG_PAGE_CTC, DIALOG_END, DIALOG_END_CTC };
+
+    long step();
+    long revealText();
+    long revealLines();
+    void layoutLines();
+    int16_t measureChar(char);
+
+    uint8_t textspeed;
+    long chardelay, headerdelay, timer;
+    uint8_t timedinput, timedend, onebyone;
+    const char* headertext;
+    const char* dialog;
+    int size, index, groupoffset;
+    uint8_t phase;
+    CtcEffect ctc;                        // The CTC wait currently in progress, if any.
+
+    DialogLine lines[SSD1306FUNC_DIALOG_LINES];   // The lines laid out so far, the one being revealed at `lineindex`.
+    uint8_t linecount, lineindex;
+    int layoutpos;                        // Where the next `layoutLines()` carries on.
+    uint8_t row, rows;                    // Row of the current line on the dialog page, and rows per page.
+    uint8_t lineheight;
+};
+
+// A menu of options in the dialog area, one per row, with the selected one inverted. Moving the selection only inverts the
+// rows of the old and new option; the list is drawn again only when the selection scrolls past the rows that fit.
+class ChoiceEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, uint8_t, uint8_t, const char* const*, uint8_t);
+    uint8_t getChoice();
+  protected:
+    long step();
+    void drawOptions();
+    void invertOption(uint8_t);
+    void select(uint8_t);
+
+    const char* const* options;
+    uint8_t count, selected;
+    uint8_t first;                        // Option on the top row.
+    uint8_t rows, lineheight;
+    uint8_t button, nextbutton;
+    bool level, held, nextlevel, nextheld;   // Last level read from each button, and the settled level that was acted on.
+    unsigned long changed, nextchanged;
+    bool linestarted;                     // Whether serial characters came since the last line end.
+    char lastchar;
+};
+
+// Opcodes of a scene script, each followed by its arguments: 16-bit ones little-endian, signed ones two's complement, strings
+// ended by a `0`. `tools/ssd1306scene.py` writes scripts from a text file.
+#define SCENE_END 0x00                    // Ends the scene.
+#define SCENE_HEADER 0x01                 // string: the header label of the dialogs that follow.
+#define SCENE_SPEED 0x02                  // textspeed, chardelay (16), headerdelay (16), timer (16): how the dialogs that follow are revealed.
+#define SCENE_DIALOG 0x03                 // flags, string: a `drawTimedDialogText` with the current header and speed.
+#define SCENE_CLEAR 0x04                  // flags: clears the header, the dialog area and/or the whole screen.
+#define SCENE_CTC 0x05                    // button, timer (16): a CTC on `button` (`CTC_SERIAL` for the serial monitor), timed unless `timer` is `0`.
+#define SCENE_FADE 0x06                   // kind, steps, stepdelay (16), state: a fade of the given `SCENE_FADE_...` kind.
+#define SCENE_IMAGE 0x07                  // image, x (16), y (16), delaytime (16), initdelaytime (16): a `fadeInGridBitmap` of `images[image]`.
+#define SCENE_BLIT 0x08                   // image, x (16), y (16), color: draws `images[image]` at once.
+#define SCENE_SCROLL 0x09                 // image, initialdelay (16), enddelay (16), scrolldelay (16), scrollstep (signed), flags, x (16), y (16), end_y (16).
+#define SCENE_WAIT 0x0A                   // milliseconds (16): waits.
+#define SCENE_JUMP 0x0B                   // offset (16): carries on from that byte of the script, e.g. to loop it.
+#define SCENE_CHOICE 0x0C                 // button, nextbutton, count, then per option a string and an offset (16): a choice menu that carries on from the chosen option's offset.
+#define SCENE_CROSS 0x0D                  // from, to, x (16), y (16), kind, steps, stepdelay (16): a `crossFadeImages` from `images[from]` to `images[to]` with the mask of a `SCENE_FADE` kind.
+
+// `SCENE_DIALOG` flags.
+#define SCENE_ONE_BY_ONE 0x01
+#define SCENE_TIMED_INPUT 0x02
+#define SCENE_TIMED_END 0x04
+
+// `SCENE_CLEAR` flags.
+#define SCENE_CLEAR_HEADER 0x01
+#define SCENE_CLEAR_DIALOG 0x02
+#define SCENE_CLEAR_SCREEN 0x04
+
+// `SCENE_SCROLL` flags.
+#define SCENE_SNAP_TO_END 0x01
+#define SCENE_ALLOW_OVERFLOW 0x02
+
+// `SCENE_FADE` and `SCENE_CROSS` kinds. Line fades take `steps` from the script; the grid, cross and dissolve fades have a fixed number.
+#define SCENE_FADE_GRID 0
+#define SCENE_FADE_CROSS 1
+#define SCENE_FADE_VERTICAL 2
+#define SCENE_FADE_HORIZONTAL 3
+#define SCENE_FADE_DIAGONAL 4
+#define SCENE_FADE_DISSOLVE 5
+
+// Plays a scene script: dialogs, CTCs, fades and images, one after the other, from PROGMEM or through an `ImageReader`.
+// Instant opcodes run back to back in one step; the others hand each tick to the effect they started until it is done.
+class SceneEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, const uint8_t*, ImageSource**, uint8_t);
+    void begin(Adafruit_SSD1306*, ImageReader, void*, ImageSource**, uint8_t);
+  protected:
+    long step();
+    long runScript();
+    long play(SSD1306Effect&);
+    void prefetch();
+    void applyPrefetch();
+    uint8_t next();
+    uint16_t nextWord();
+    void nextString(char*, uint16_t);
+    ImageSource* nextImage();
+
+    const uint8_t* script;                // The script in PROGMEM, or `NULL` when read through `reader`.
+    ImageReader reader;
+    void* context;
+    uint16_t pos;                         // Offset of the next script byte.
+    uint8_t cache[16];                    // Script bytes read ahead through `reader`, from `cachepos`.
+    uint16_t cachepos;
+    uint8_t cachecount;
+    ImageSource** images;
+    uint8_t imagecount;
+
+    SSD1306Effect* current;               // The effect the last opcode started, while it runs.
+    DialogTextEffect dialog;
+    CtcEffect ctc;
+    MaskFadeEffect fade;
+    FadeInGridBitmapEffect image;
+    VerticalScrollEffect scroll;
+    ChoiceEffect choice;
+    CrossFadeEffect cross;
+
+    const char* choices[SSD1306FUNC_SCENE_CHOICES];   // Options of the choice menu, kept in `text`.
+    uint16_t targets[SSD1306FUNC_SCENE_CHOICES];      // Script offset each option carries on from.
+
+    char header[SSD1306FUNC_SCENE_HEADER + 1];
+    char text[SSD1306FUNC_SCENE_TEXT + 1];
+    uint8_t textspeed;
+    long chardelay, headerdelay, timer;
+
+    bool prefetching;                     // Whether `runScript()` only runs instant opcodes, into the second framebuffer.
+    bool prefetched;                      // Whether the opcodes after the current wait have already been drawn ahead.
+#if SSD1306FUNC_SCENE_PREFETCH
+    uint8_t prefetchStart[SSD1306FUNC_MAX_PAGES];   // Columns of each page the drawing ahead changed, as in the dirty tracking.
+    uint8_t prefetchEnd[SSD1306FUNC_MAX_PAGES];
+#endif
+};
+
+void playScene(Adafruit_SSD1306*, const uint8_t*, ImageSource**, uint8_t);
+void playScene(Adafruit_SSD1306*, ImageReader, void*, ImageSource**, uint8_t);
+
+// Fades a screen drawn a page at a time by a `PageRenderer`, like `MaskFadeEffect` without the framebuffer.
+class PageFadeEffect : public SSD1306Effect {
+  public:
+    void begin(Adafruit_SSD1306*, PageRenderer, void*, FadeMask, long, uint16_t);
+  protected:
+    long step();
+    static void renderPage(Adafruit_SSD1306*, uint8_t, uint8_t*, void*);
+
+    PageRenderer renderer;
+    void* context;
+    FadeMask mask;
+    long stepdelay;
+    uint16_t state;
+};
+
+void releaseFramebuffer(Adafruit_SSD1306*);
+void renderPages(Adafruit_SSD1306*, PageRenderer, void*);
+void blitImageToPage(Adafruit_SSD1306*, uint8_t, uint8_t*, int16_t, int16_t, ImageSource&, uint16_t);
+void writeTextToPage(Adafruit_SSD1306*, uint8_t, uint8_t*, int16_t, int16_t, const char*);
+void applyMaskToPage(Adafruit_SSD1306*, uint8_t, uint8_t*, FadeMask, uint16_t, uint16_t);
+void fadePages(Adafruit_SSD1306*, PageRenderer, void*, FadeMask, long, uint16_t);
+
+void runEffect(SSD1306Effect&);
+void runEffects(SSD1306Effect**, uint8_t);
+#if SSD1306FUNC_STATS
+EffectStats getLastEffectStats();
+void printEffectStats(Print&, EffectStats);
+unsigned long estimateBusMicros(unsigned long, uint32_t, bool);
+void printBusEstimates(Print&, EffectStats);
+#endif
 
 
 #endif
\ No newline at end of file
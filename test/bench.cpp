@@ -0,0 +1,123 @@
+// Runs every blocking function of SSD1306Func on the mock display and reports, per call, what
+// was drawn and what it cost on the bus. Only the original API is used, so the same driver
+// builds against older checkouts for before/after comparisons (see README.md).
+//
+// bench          the full table
+// bench golden   only the snapshot columns, compared against golden/bench.txt by run.sh
+#include "SSD1306Func.h"
+
+static uint8_t bits1[128 * 64 / 8], bits2[100 * 40 / 8 + 40], bits3[128 * 200 / 8], bits4[37 * 90 / 8 + 100];
+static Adafruit_SSD1306 display(128, 64, &Wire);
+static bool golden = false;
+
+// FNV-1a
+static uint32_t hashBytes(const uint8_t* data, int length) {
+  uint32_t hash = 2166136261u;
+  while (length--) hash = (hash ^ *data++) * 16777619u;
+  return hash;
+}
+
+// Flush time in ms for the traffic seen since the last report. I2C: 9 clocks per byte on the
+// wire plus a start and stop per transaction. SPI: 8 clocks per command or data byte.
+static float getI2cMillis(uint32_t hz) {
+  return (Wire.bytes * 9.0f + Wire.transactions * 2.0f) * 1000.0f / hz;
+}
+
+static float getSpiMillis(uint32_t hz) {
+  return (g_ctl.commands + g_ctl.databytes) * 8.0f * 1000.0f / hz;
+}
+
+static void fillRandom(uint8_t* data, int length, uint32_t seed) {
+  for (int i = 0; i < length; i++) {
+    seed = seed * 1103515245u + 12345u;
+    data[i] = seed >> 16;
+  }
+}
+
+// Prints one row and starts the counters and the clock over
+static void report(const char* name) {
+  uint8_t* buffer = display.getBuffer();
+  bool shown = true;
+  for (int p = 0; p < 8; p++) if (memcmp(g_ctl.ram[p], buffer + p * 128, 128)) shown = false;
+
+  printf("%-24s %08x %-8s sl=%d", name, hashBytes(buffer, 1024), shown ? "ram=buf" : "RAM!=BUF", g_ctl.startline);
+  if (!golden) {
+    if (g_ctl.startline < 10) printf(" ");
+    unsigned long flushes = g_ctl.flushes;
+    printf(" %6lums %6lu %5lu %4lu %3lu %7lu %6lu %8.1f %8.1f %8.1f %8.1f", (unsigned long)(g_micros / 1000), Wire.bytes, Wire.transactions,
+           flushes, g_full_displays, g_pixel_ops, flushes ? g_pixel_ops / flushes : g_pixel_ops,
+           getI2cMillis(100000), getI2cMillis(400000), getI2cMillis(1000000), getSpiMillis(8000000));
+  }
+  printf("\n");
+
+  Wire.bytes = Wire.transactions = 0;
+  g_ctl.commands = g_ctl.databytes = g_ctl.flushes = 0;
+  g_full_displays = g_pixel_ops = 0;
+  g_micros = 0;
+}
+
+int main(int argc, char** argv) {
+  golden = argc > 1 && !strcmp(argv[1], "golden");
+  if (!golden) {
+    printf("%-24s %-8s %-8s %-5s %8s %6s %5s %4s %3s %7s %6s %8s %8s %8s %8s\n", "function", "fb hash", "shown", "start", "time", "bytes",
+           "tx", "win", "fs", "px", "px/win", "i2c100k", "i2c400k", "i2c1M", "spi8M");
+  }
+
+  fillRandom(bits1, sizeof(bits1), 1);
+  fillRandom(bits2, sizeof(bits2), 2);
+  fillRandom(bits3, sizeof(bits3), 3);
+  fillRandom(bits4, sizeof(bits4), 4);
+  Image image1 = {bits1, 128, 64}, image2 = {bits2, 100, 40}, image3 = {bits3, 128, 200}, image4 = {bits4, 37, 90};
+
+  display.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  display.setTextColor(SSD1306_WHITE);
+  g_serial_at = 1000;
+
+  fillScreenSlow(&display); report("fillScreenSlow");
+  fillScreenFast(&display); report("fillScreenFast");
+  display.clearDisplay(); display.display();
+  fadeGrid(&display, -1, 1); report("fadeGrid on");
+  fadeGrid(&display, -1, 0); report("fadeGrid off");
+  fadeCross(&display, -1, 1); report("fadeCross on");
+  fadeCross(&display, -1, 0); report("fadeCross off");
+  for (int cycle = 1; cycle <= 9; cycle += 2) { fadeVertical(&display, cycle, -1, 1); report("fadeVertical on"); fadeVertical(&display, cycle, 100, 0); report("fadeVertical off"); }
+  for (int cycle = 1; cycle <= 9; cycle += 2) { fadeHorizontal(&display, cycle, -1, 1); report("fadeHorizontal on"); fadeHorizontal(&display, cycle, 100, 0); report("fadeHorizontal off"); }
+  for (int cycle = 1; cycle <= 9; cycle += 2) { fadeDiagonal(&display, cycle, -1, 1); report("fadeDiagonal on"); fadeDiagonal(&display, cycle, 100, 0); report("fadeDiagonal off"); }
+  fadeVertical(&display, -1, -1, 1); report("fadeVertical def");
+  fadeHorizontal(&display, -1, -1, 0); report("fadeHorizontal def");
+  fadeDiagonal(&display, -1, -1, 1); report("fadeDiagonal def");
+
+  display.clearDisplay(); display.display();
+  fadeInGridBitmap(&display, -1, -1, 0, 0, image1); report("fadeInGridBitmap 128x64");
+  fadeInGridBitmap(&display, -1, -1, 5, 3, image2); report("fadeInGridBitmap 100x40");
+  fadeInGridBitmap(&display, -1, -1, -7, 13, image4); report("fadeInGridBitmap 37x90");
+
+  display.clearDisplay(); display.display();
+  drawVerticalScrollingBitmap(&display, -1, -1, -1, 1, false, false, 0, 0, 0, image3); report("scroll down 1");
+  display.clearDisplay(); display.display();
+  drawVerticalScrollingBitmap(&display, -1, -1, -1, 3, false, false, 0, 0, 0, image3); report("scroll down 3");
+  display.clearDisplay(); display.display();
+  drawVerticalScrollingBitmap(&display, -1, -1, -1, 7, true, false, 0, 0, 20, image3); report("scroll down 7 snap");
+  display.clearDisplay(); display.display();
+  drawVerticalScrollingBitmap(&display, -1, -1, -1, -2, false, false, 0, -136, 0, image3); report("scroll up 2");
+  display.clearDisplay(); display.display();
+  drawVerticalScrollingBitmap(&display, -1, -1, -1, -5, false, true, 0, -136, 10, image3); report("scroll up 5");
+  display.clearDisplay(); display.display();
+  drawVerticalScrollingBitmap(&display, -1, -1, -1, 2, false, false, 10, 4, 0, image4); report("scroll 37x90 down");
+
+  display.clearDisplay(); display.display();
+  g_serial_at = 2000;
+  drawDialogText(&display, 1, -1, -1, 1, "Header", "Hello there, this is a test of the dialog` system with a CTC."); report("drawDialogText 1");
+  clearHeaderText(&display); report("clearHeaderText");
+  clearDialogText(&display); report("clearDialogText");
+  drawDialogText(&display, 3, -1, -1, 1, "Hdr", "Grouped reveal of text` with some more characters here."); report("drawDialogText 3");
+  clearDialogText(&display); clearHeaderText(&display);
+  drawDialogText(&display, 1, -1, -1, 0, "Instant", "Instant text."); report("drawDialogText instant");
+  clearDialogText(&display); clearHeaderText(&display);
+  drawTimedDialogText(&display, 2, -1, -1, 700, 1, 1, 1, "Timed", "Timed text` and then the end."); report("drawTimedDialogText");
+  clearDialogText(&display); clearHeaderText(&display);
+  ctcTimedSerial(&display, 1300); report("ctcTimedSerial");
+  g_pinlevel[2] = LOW;
+  ctcTimed(&display, 2, 800); report("ctcTimed");
+  return 0;
+}
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Writes the PBM test images that run.sh converts with tools/ssd1306img.py.
+
+    python3 test/images.py OUTDIR
+
+a.pbm 128x512, b.pbm 100x77 and c.pbm 37x20 are laid out from a few dozen 8x8 tiles, blank and
+solid ones included, so the RLE format finds runs and the tile format stays under 256 tiles.
+f0.pbm to f5.pbm are frames of a block walking over a fixed background, for the delta format.
+"""
+
+import os
+import sys
+
+
+class Random:
+    """The C library's LCG, so the images do not depend on the Python version."""
+
+    def __init__(self, seed):
+        self.state = seed
+
+    def next(self, n):
+        self.state = (self.state * 1103515245 + 12345) & 0xFFFFFFFF
+        return (self.state >> 16) % n
+
+
+def write_pbm(path, pixels):
+    height, width = len(pixels), len(pixels[0])
+    with open(path, "wb") as f:
+        f.write(b"P4\n%d %d\n" % (width, height))
+        for row in pixels:
+            for x in range(0, width, 8):
+                byte = 0
+                for bit in range(8):
+                    # PBM stores 1 for black, i.e. an off pixel
+                    if x + bit < width and not row[x + bit]:
+                        byte |= 0x80 >> bit
+                f.write(bytes([byte]))
+
+
+def tiled(width, height, seed):
+    rnd = Random(seed)
+    tiles = [[[False] * 8 for _ in range(8)], [[True] * 8 for _ in range(8)]]
+    tiles += [[[rnd.next(2) == 1 for _ in range(8)] for _ in range(8)] for _ in range(30)]
+    layout = {}
+    for ty in range((height + 7) // 8):
+        for tx in range((width + 7) // 8):
+            kind = rnd.next(4)
+            layout[tx, ty] = 0 if kind == 0 else 1 if kind == 1 else 2 + rnd.next(len(tiles) - 2)
+    return [[tiles[layout[x // 8, y // 8]][y % 8][x % 8] for x in range(width)] for y in range(height)]
+
+
+def frame(step):
+    pixels = [[y >= 56 or (x + y) % 16 == 0 for x in range(128)] for y in range(64)]
+    left, top = 10 + step * 17, 20
+    for y in range(top, top + 30):
+        for x in range(left, left + 20):
+            pixels[y][x] = (x - left) % 5 != 0 or y - top < 4
+    return pixels
+
+
+def main():
+    out = sys.argv[1]
+    os.makedirs(out, exist_ok=True)
+    write_pbm(os.path.join(out, "a.pbm"), tiled(128, 512, 1))
+    write_pbm(os.path.join(out, "b.pbm"), tiled(100, 77, 2))
+    write_pbm(os.path.join(out, "c.pbm"), tiled(37, 20, 3))
+    for step in range(6):
+        write_pbm(os.path.join(out, "f%d.pbm" % step), frame(step))
+
+
+if __name__ == "__main__":
+    main()
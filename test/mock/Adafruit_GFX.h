@@ -0,0 +1,74 @@
+// Host stand-in for Adafruit_GFX: the drawing primitives SSD1306Func calls, written the way the
+// library writes them, so they reach drawPixel() in the same order and the pixel counts match.
+#ifndef MOCK_ADAFRUIT_GFX_H
+#define MOCK_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+typedef struct {
+  uint16_t bitmapOffset;
+  uint8_t width, height, xAdvance;
+  int8_t xOffset, yOffset;
+} GFXglyph;
+
+typedef struct {
+  uint8_t* bitmap;
+  GFXglyph* glyph;
+  uint16_t first, last;
+  uint8_t yAdvance;
+} GFXfont;
+
+// A stand-in for glcdfont.c: 5 columns for each of the 256 characters
+extern const unsigned char mock_font[256 * 5];
+
+class Adafruit_GFX : public Print {
+  public:
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color); }
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color); }
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color); }
+    virtual void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+      drawFastHLine(x, y, w, color);
+      drawFastHLine(x, y + h - 1, w, color);
+      drawFastVLine(x, y, h, color);
+      drawFastVLine(x + w - 1, y, h, color);
+    }
+    virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
+    void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color);
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) { drawChar(x, y, c, color, bg, size, size); }
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
+    size_t write(uint8_t c);
+    using Print::write;
+
+    void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+    int16_t getCursorX() const { return cursor_x; }
+    int16_t getCursorY() const { return cursor_y; }
+    void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+    void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+    void setTextSize(uint8_t s) { textsize_x = textsize_y = s; }
+    void setTextWrap(bool w) { wrap = w; }
+    void cp437(bool x = true) { _cp437 = x; }
+    void setFont(const GFXfont* f = NULL) { gfxFont = (GFXfont*)f; }
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+    uint8_t getRotation() const { return rotation; }
+    void setRotation(uint8_t r) {
+      rotation = r & 3;
+      _width = (rotation & 1) ? HEIGHT : WIDTH;
+      _height = (rotation & 1) ? WIDTH : HEIGHT;
+    }
+
+  protected:
+    const int16_t WIDTH, HEIGHT;
+    int16_t _width, _height, cursor_x = 0, cursor_y = 0;
+    uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+    uint8_t textsize_x = 1, textsize_y = 1, rotation = 0;
+    bool wrap = true, _cp437 = false;
+    GFXfont* gfxFont = NULL;
+};
+
+#endif
@@ -0,0 +1,105 @@
+// Host stand-in for Adafruit_SSD1306 on I2C. Its byte stream goes to an emulated controller,
+// MockController, which keeps the GDDRAM, the address window and the start line the way the
+// chip would. Tests compare that RAM against the framebuffer to prove what reached the panel.
+#ifndef MOCK_ADAFRUIT_SSD1306_H
+#define MOCK_ADAFRUIT_SSD1306_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <Adafruit_GFX.h>
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+#define BLACK SSD1306_BLACK
+#define WHITE SSD1306_WHITE
+#define INVERSE SSD1306_INVERSE
+
+#define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_SETCONTRAST 0x81
+#define SSD1306_CHARGEPUMP 0x8D
+#define SSD1306_SEGREMAP 0xA0
+#define SSD1306_DISPLAYALLON_RESUME 0xA4
+#define SSD1306_DISPLAYALLON 0xA5
+#define SSD1306_NORMALDISPLAY 0xA6
+#define SSD1306_INVERTDISPLAY 0xA7
+#define SSD1306_SETMULTIPLEX 0xA8
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+#define SSD1306_COMSCANINC 0xC0
+#define SSD1306_COMSCANDEC 0xC8
+#define SSD1306_SETDISPLAYOFFSET 0xD3
+#define SSD1306_SETDISPLAYCLOCKDIV 0xD5
+#define SSD1306_SETPRECHARGE 0xD9
+#define SSD1306_SETCOMPINS 0xDA
+#define SSD1306_SETVCOMDETECT 0xDB
+#define SSD1306_SETLOWCOLUMN 0x00
+#define SSD1306_SETHIGHCOLUMN 0x10
+#define SSD1306_SETSTARTLINE 0x40
+#define SSD1306_EXTERNALVCC 0x01
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_RIGHT_HORIZONTAL_SCROLL 0x26
+#define SSD1306_LEFT_HORIZONTAL_SCROLL 0x27
+#define SSD1306_VERTICAL_AND_RIGHT_HORIZONTAL_SCROLL 0x29
+#define SSD1306_VERTICAL_AND_LEFT_HORIZONTAL_SCROLL 0x2A
+#define SSD1306_DEACTIVATE_SCROLL 0x2E
+#define SSD1306_ACTIVATE_SCROLL 0x2F
+#define SSD1306_SET_VERTICAL_SCROLL_AREA 0xA3
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+  public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst_pin = -1, uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+    ~Adafruit_SSD1306(void);
+    bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0, bool reset = true, bool periphBegin = true);
+    void display(void);
+    void clearDisplay(void);
+    void invertDisplay(bool i);
+    void dim(bool dim);
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void startscrollright(uint8_t start, uint8_t stop);
+    void startscrollleft(uint8_t start, uint8_t stop);
+    void stopscroll(void);
+    void ssd1306_command(uint8_t c);
+    bool getPixel(int16_t x, int16_t y);
+    uint8_t* getBuffer(void);
+
+  protected:
+    void ssd1306_command1(uint8_t c);
+    void ssd1306_commandList(const uint8_t* c, uint8_t n);
+
+    SPIClass* spi;
+    TwoWire* wire;
+    uint8_t* buffer;
+    int8_t i2caddr, vccstate, page_end;
+    int8_t mosiPin, clkPin, dcPin, csPin, rstPin;
+    uint32_t wireClk;
+    uint32_t restoreClk;
+    uint8_t contrast;
+    SPISettings spiSettings;
+};
+
+// The controller at the other end of the bus. All displays share it, like panels behind a multiplexer.
+struct MockController {
+  uint8_t ram[8][128];
+  uint8_t c0 = 0, c1 = 127, p0 = 0, p1 = 7, col = 0, page = 0;
+  uint8_t startline = 0, contrast = 0x7F;
+
+  // Command and data bytes received
+  unsigned long commands = 0, databytes = 0;
+  // Address windows that received data, i.e. separate flushes, full or partial
+  unsigned long flushes = 0;
+};
+
+extern MockController g_ctl;
+
+// drawPixel() calls, whether from GFX primitives or the library's own fallbacks
+extern unsigned long g_pixel_ops;
+// Full-screen display() calls
+extern unsigned long g_full_displays;
+
+#endif
@@ -0,0 +1,116 @@
+// Host stand-in for the parts of the Arduino core that SSD1306Func uses.
+// Time only moves when the code under test asks for it or talks to the bus,
+// so every run of a test is cycle-for-cycle the same.
+#ifndef MOCK_ARDUINO_H
+#define MOCK_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#define ARDUINO 10813
+#define F_CPU 16000000UL
+#if defined(__AVR__)
+// The TWI bit rate register, so tests built with -D__AVR__ take the AVR clock paths
+extern volatile uint8_t g_twbr;
+#define TWBR g_twbr
+#endif
+#define PROGMEM
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT -1
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_ptr(p) (*(void* const*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper*)(s))
+
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Simulated time in microseconds. Reading the clock costs 1 us, so polling loops always end.
+extern uint64_t g_micros;
+inline unsigned long micros() { g_micros += 1; return (unsigned long)g_micros; }
+inline unsigned long millis() { g_micros += 1; return (unsigned long)(g_micros / 1000); }
+inline void delay(unsigned long ms) { g_micros += ms * 1000ULL; }
+inline void delayMicroseconds(unsigned int us) { g_micros += us; }
+inline void yield() { g_micros += 1; }
+
+// Pin levels that tests set by hand, and the interrupt handlers attached to pins 0 to 3.
+extern int g_pinlevel[64];
+extern void (*g_isr[4])(void);
+inline int digitalRead(uint8_t pin) { return g_pinlevel[pin]; }
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalPinToInterrupt(uint8_t pin) { return pin < 4 ? pin : NOT_AN_INTERRUPT; }
+void attachInterrupt(int, void (*)(void), int);
+void detachInterrupt(int);
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) { size_t n = 0; while (size--) n += write(*buffer++); return n; }
+    size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+    size_t print(const char* s) { return write(s); }
+    size_t print(const __FlashStringHelper* s) { return write((const char*)s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(long v) { char b[24]; snprintf(b, sizeof(b), "%ld", v); return write(b); }
+    size_t print(unsigned long v) { char b[24]; snprintf(b, sizeof(b), "%lu", v); return write(b); }
+    size_t print(int v) { return print((long)v); }
+    size_t print(unsigned int v) { return print((unsigned long)v); }
+    size_t println() { return write("\n"); }
+    template <class T> size_t println(T v) { size_t n = print(v); return n + println(); }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    size_t readBytes(uint8_t* buffer, size_t length) { size_t n = 0; while (n < length && available()) buffer[n++] = read(); return n; }
+};
+
+// Serial input arrives as scripted keys: the first one at g_serial_at (in ms), then one every
+// g_key_gap ms. The keys are g_serial_keys if set, or an endless run of 'x'.
+extern unsigned long g_serial_at, g_key_gap;
+extern const char* g_serial_keys;
+
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) { if (echo) fputc(c, stdout); return 1; }
+    using Print::write;
+    int available();
+    int read();
+    int peek() { return available() ? (g_serial_keys ? *g_serial_keys : 'x') : -1; }
+
+    // Copies output to stdout when set
+    bool echo = false;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,29 @@
+// Host stand-in for SPIClass. The mock display is always on I2C, so this only has to compile and keep the clock it is set to.
+#ifndef MOCK_SPI_H
+#define MOCK_SPI_H
+
+#include <Arduino.h>
+
+#define SPI_HAS_TRANSACTION 1
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPISettings {
+  public:
+    SPISettings() : clock(4000000) {}
+    SPISettings(uint32_t hz, uint8_t, uint8_t) : clock(hz) {}
+    uint32_t clock;
+};
+
+class SPIClass {
+  public:
+    void begin() {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction() {}
+    uint8_t transfer(uint8_t b) { return b; }
+    void transfer(void*, size_t) {}
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,30 @@
+// Host stand-in for TwoWire. Every transaction is timed at the current clock and fed to the
+// emulated controller in Adafruit_SSD1306.h.
+#ifndef MOCK_WIRE_H
+#define MOCK_WIRE_H
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 32
+
+class TwoWire {
+  public:
+    void begin() {}
+    void setClock(uint32_t hz) { clock = hz; }
+    uint32_t getClock() { return clock; }
+    void beginTransmission(uint8_t address) { this->address = address; length = 0; }
+    size_t write(uint8_t b) { if (length >= BUFFER_LENGTH) { overflows++; return 0; } buffer[length++] = b; return 1; }
+    size_t write(const uint8_t* data, size_t size) { size_t n = 0; while (size--) n += write(*data++); return n; }
+    uint8_t endTransmission(bool stop = true);
+
+    uint32_t clock = 100000;
+    uint8_t address = 0, length = 0;
+    uint8_t buffer[BUFFER_LENGTH];
+
+    // Transactions, bytes on the wire including the address byte, and writes past BUFFER_LENGTH
+    unsigned long transactions = 0, bytes = 0, overflows = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,348 @@
+// Definitions for the host mocks, and the SSD1306 controller emulation behind them.
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+
+uint64_t g_micros = 0;
+int g_pinlevel[64];
+void (*g_isr[4])(void);
+unsigned long g_serial_at = ~0UL, g_key_gap = 1500;
+const char* g_serial_keys = NULL;
+unsigned long g_pixel_ops = 0, g_full_displays = 0;
+
+HardwareSerial Serial;
+TwoWire Wire;
+SPIClass SPI;
+volatile uint8_t g_twbr;
+MockController g_ctl;
+
+void attachInterrupt(int interrupt, void (*isr)(void), int) {
+  if (interrupt >= 0 && interrupt < 4) g_isr[interrupt] = isr;
+}
+
+void detachInterrupt(int interrupt) {
+  if (interrupt >= 0 && interrupt < 4) g_isr[interrupt] = NULL;
+}
+
+int HardwareSerial::available() {
+  if (g_serial_keys && !*g_serial_keys) return 0;
+  return g_micros / 1000 >= g_serial_at;
+}
+
+int HardwareSerial::read() {
+  if (!available()) return -1;
+  g_serial_at = g_micros / 1000 + g_key_gap;
+  return g_serial_keys ? *g_serial_keys++ : 'x';
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// GFX
+
+#define FONT_BYTE(i) (uint8_t)(((i) * 37 + 11) & 0x7F)
+#define FONT_CHAR(c) FONT_BYTE(c * 5), FONT_BYTE(c * 5 + 1), FONT_BYTE(c * 5 + 2), FONT_BYTE(c * 5 + 3), FONT_BYTE(c * 5 + 4)
+#define FONT_8(c) FONT_CHAR(c * 8), FONT_CHAR(c * 8 + 1), FONT_CHAR(c * 8 + 2), FONT_CHAR(c * 8 + 3), FONT_CHAR(c * 8 + 4), FONT_CHAR(c * 8 + 5), FONT_CHAR(c * 8 + 6), FONT_CHAR(c * 8 + 7)
+#define FONT_64(c) FONT_8(c * 8), FONT_8(c * 8 + 1), FONT_8(c * 8 + 2), FONT_8(c * 8 + 3), FONT_8(c * 8 + 4), FONT_8(c * 8 + 5), FONT_8(c * 8 + 6), FONT_8(c * 8 + 7)
+
+// Arbitrary but fixed glyphs: only the text tests' agreement with GFX matters, not legibility
+const unsigned char mock_font[256 * 5] = {FONT_64(0), FONT_64(1), FONT_64(2), FONT_64(3)};
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  int16_t t;
+  if (x0 == x1) {
+    if (y0 > y1) { t = y0; y0 = y1; y1 = t; }
+    drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    return;
+  }
+  if (y0 == y1) {
+    if (x0 > x1) { t = x0; x0 = x1; x1 = t; }
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    return;
+  }
+
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) { t = x0; x0 = y0; y0 = t; t = x1; x1 = y1; y1 = t; }
+  if (x0 > x1) { t = x0; x0 = x1; x1 = t; t = y0; y0 = y1; y1 = t; }
+  int16_t dx = x1 - x0, dy = abs(y1 - y0), err = dx / 2, ystep = y0 < y1 ? 1 : -1;
+  for (; x0 <= x1; x0++) {
+    if (steep) drawPixel(y0, x0, color);
+    else drawPixel(x0, y0, color);
+    err -= dy;
+    if (err < 0) { y0 += ystep; err += dx; }
+  }
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
+  int16_t bytewidth = (w + 7) / 8;
+  uint8_t b = 0;
+  for (int16_t j = 0; j < h; j++, y++) {
+    for (int16_t i = 0; i < w; i++) {
+      if (i & 7) b <<= 1;
+      else b = pgm_read_byte(&bitmap[j * bytewidth + i / 8]);
+      if (b & 0x80) drawPixel(x + i, y, color);
+    }
+  }
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color) {
+  drawBitmap(x, y, (const uint8_t*)bitmap, w, h, color);
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y) {
+  if (x >= _width || y >= _height || x + 6 * size_x - 1 < 0 || y + 8 * size_y - 1 < 0) return;
+  if (!_cp437 && c >= 176) c++;
+
+  for (int8_t i = 0; i < 5; i++) {
+    uint8_t line = mock_font[c * 5 + i];
+    for (int8_t j = 0; j < 8; j++, line >>= 1) {
+      if (line & 1) {
+        if (size_x == 1 && size_y == 1) drawPixel(x + i, y + j, color);
+        else fillRect(x + i * size_x, y + j * size_y, size_x, size_y, color);
+      } else if (bg != color) {
+        if (size_x == 1 && size_y == 1) drawPixel(x + i, y + j, bg);
+        else fillRect(x + i * size_x, y + j * size_y, size_x, size_y, bg);
+      }
+    }
+  }
+  if (bg != color) {
+    if (size_x == 1 && size_y == 1) drawFastVLine(x + 5, y, 8, bg);
+    else fillRect(x + 5 * size_x, y, size_x, 8 * size_y, bg);
+  }
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += textsize_y * 8;
+  } else if (c != '\r') {
+    if (wrap && cursor_x + textsize_x * 6 > _width) {
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    }
+    drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+    cursor_x += textsize_x * 6;
+  }
+  return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// CONTROLLER
+
+// Parameter bytes that follow each multi-byte command the library sends
+static int getArgumentCount(uint8_t c) {
+  switch (c) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+    case 0x21: case 0x22: case 0xA3: return 2;
+    case 0x29: case 0x2A: return 5;
+    case 0x26: case 0x27: return 6;
+  }
+  return 0;
+}
+
+static uint8_t command[8];
+static int commandlength = 0, argumentsleft = -1;
+static bool windowopened = false;
+
+static void receiveCommand(uint8_t b) {
+  g_ctl.commands++;
+  if (argumentsleft < 0) {
+    command[0] = b;
+    commandlength = 1;
+    argumentsleft = getArgumentCount(b);
+  } else {
+    command[commandlength++] = b;
+    argumentsleft--;
+  }
+  if (argumentsleft > 0) return;
+  argumentsleft = -1;
+
+  uint8_t c = command[0];
+  if (c == SSD1306_COLUMNADDR) {
+    g_ctl.c0 = command[1] & 127;
+    g_ctl.c1 = command[2] & 127;
+    g_ctl.col = g_ctl.c0;
+    windowopened = true;
+  } else if (c == SSD1306_PAGEADDR) {
+    g_ctl.p0 = command[1] & 7;
+    g_ctl.p1 = command[2] > 7 ? 7 : command[2];
+    g_ctl.page = g_ctl.p0;
+    windowopened = true;
+  } else if (c >= SSD1306_SETSTARTLINE && c < SSD1306_SETSTARTLINE + 64) {
+    g_ctl.startline = c - SSD1306_SETSTARTLINE;
+  } else if (c == SSD1306_SETCONTRAST) {
+    g_ctl.contrast = command[1];
+  }
+}
+
+// Horizontal addressing mode: columns advance, then pages, wrapping inside the window
+static void receiveData(uint8_t b) {
+  if (windowopened) g_ctl.flushes++;
+  windowopened = false;
+  g_ctl.databytes++;
+  g_ctl.ram[g_ctl.page][g_ctl.col] = b;
+  if (g_ctl.col != g_ctl.c1) g_ctl.col++;
+  else {
+    g_ctl.col = g_ctl.c0;
+    g_ctl.page = g_ctl.page == g_ctl.p1 ? g_ctl.p0 : g_ctl.page + 1;
+  }
+}
+
+// 9 clocks per byte, the address byte included
+uint8_t TwoWire::endTransmission(bool) {
+  transactions++;
+  bytes += length + 1;
+  g_micros += (uint64_t)(length + 1) * 9 * 1000000ULL / clock;
+
+  uint8_t i = 0;
+  while (i < length) {
+    uint8_t control = buffer[i++];
+    bool continuation = control & 0x80, data = control & 0x40;
+    if (continuation) {
+      if (i < length) data ? receiveData(buffer[i++]) : receiveCommand(buffer[i++]);
+      continue;
+    }
+    for (; i < length; i++) data ? receiveData(buffer[i]) : receiveCommand(buffer[i]);
+  }
+  length = 0;
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// SSD1306
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t, uint32_t clkDuring, uint32_t clkAfter)
+  : Adafruit_GFX(w, h), spi(NULL), wire(twi), buffer(NULL), i2caddr(0x3C), dcPin(-1), csPin(-1), wireClk(clkDuring), restoreClk(clkAfter) {}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+  free(buffer);
+}
+
+bool Adafruit_SSD1306::begin(uint8_t, uint8_t addr, bool, bool) {
+  buffer = (uint8_t*)calloc(WIDTH * ((HEIGHT + 7) / 8), 1);
+  if (addr) i2caddr = addr;
+  return buffer != NULL;
+}
+
+void Adafruit_SSD1306::ssd1306_command1(uint8_t c) {
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x00);
+  wire->write(c);
+  wire->endTransmission();
+}
+
+void Adafruit_SSD1306::ssd1306_commandList(const uint8_t* c, uint8_t n) {
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x00);
+  uint16_t bytesout = 1;
+  while (n--) {
+    if (bytesout >= BUFFER_LENGTH) {
+      wire->endTransmission();
+      wire->beginTransmission(i2caddr);
+      wire->write((uint8_t)0x00);
+      bytesout = 1;
+    }
+    wire->write(*c++);
+    bytesout++;
+  }
+  wire->endTransmission();
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+  wire->setClock(wireClk);
+  ssd1306_command1(c);
+  wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::display() {
+  static const uint8_t dlist1[] = {SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0};
+
+  g_full_displays++;
+  wire->setClock(wireClk);
+  ssd1306_commandList(dlist1, sizeof(dlist1));
+  ssd1306_command1(WIDTH - 1);
+
+  uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+  uint8_t* ptr = buffer;
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x40);
+  uint16_t bytesout = 1;
+  while (count--) {
+    if (bytesout >= BUFFER_LENGTH) {
+      wire->endTransmission();
+      wire->beginTransmission(i2caddr);
+      wire->write((uint8_t)0x40);
+      bytesout = 1;
+    }
+    wire->write(*ptr++);
+    bytesout++;
+  }
+  wire->endTransmission();
+  wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+  memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+}
+
+void Adafruit_SSD1306::invertDisplay(bool i) {
+  ssd1306_command(i ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
+}
+
+void Adafruit_SSD1306::dim(bool dim) {
+  // As in the library: the begin() default, not whatever contrast was sent since
+  uint8_t contrast = dim ? 0 : vccstate == SSD1306_EXTERNALVCC ? 0x9F : 0xCF;
+  wire->setClock(wireClk);
+  ssd1306_command1(SSD1306_SETCONTRAST);
+  ssd1306_command1(contrast);
+  wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  g_pixel_ops++;
+  if (x < 0 || x >= width() || y < 0 || y >= height()) return;
+
+  int16_t t;
+  switch (rotation) {
+    case 1: t = x; x = WIDTH - y - 1; y = t; break;
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: t = x; x = y; y = HEIGHT - t - 1; break;
+  }
+  switch (color) {
+    case SSD1306_WHITE: buffer[x + (y / 8) * WIDTH] |= 1 << (y & 7); break;
+    case SSD1306_BLACK: buffer[x + (y / 8) * WIDTH] &= ~(1 << (y & 7)); break;
+    case SSD1306_INVERSE: buffer[x + (y / 8) * WIDTH] ^= 1 << (y & 7); break;
+  }
+}
+
+void Adafruit_SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+}
+
+void Adafruit_SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+}
+
+void Adafruit_SSD1306::startscrollright(uint8_t, uint8_t) {}
+
+void Adafruit_SSD1306::startscrollleft(uint8_t, uint8_t) {}
+
+void Adafruit_SSD1306::stopscroll() {
+  ssd1306_command(SSD1306_DEACTIVATE_SCROLL);
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+  if (x < 0 || x >= width() || y < 0 || y >= height()) return false;
+
+  int16_t t;
+  switch (rotation) {
+    case 1: t = x; x = WIDTH - y - 1; y = t; break;
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: t = x; x = y; y = HEIGHT - t - 1; break;
+  }
+  return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+}
+
+uint8_t* Adafruit_SSD1306::getBuffer() {
+  return buffer;
+}
@@ -0,0 +1,118 @@
+#!/bin/sh
+# Builds SSD1306Func against the host mocks in test/mock and checks it:
+#
+#   test/run.sh              warnings in every configuration, the benchmark snapshot, all tests
+#   test/run.sh test_ctc ... only the named tests
+#   test/run.sh --bench      only the benchmark: the snapshot, then the table, plain and with
+#                            SSD1306FUNC_ASYNC_FLUSH
+#   test/run.sh --update     rewrite golden/bench.txt from this tree, then run everything
+#
+# SRC points at another checkout to build that instead, e.g. to benchmark an older commit with
+# this harness (see README.md). CXX and BUILD pick the compiler and the output directory.
+set -e
+
+TEST=$(cd "$(dirname "$0")" && pwd)
+ROOT=${SRC:-$(dirname "$TEST")}
+TOOLS=$(dirname "$TEST")/tools
+BUILD=${BUILD:-$TEST/build}
+CXX=${CXX:-g++}
+WARN="-Wall -Wextra -Wno-unused-parameter -Werror"
+FLAGS="-std=gnu++11 -g -O1 -I$TEST/mock -I$ROOT -I$BUILD/gen"
+SANITIZE="-fsanitize=address,undefined -fno-sanitize-recover=undefined"
+MODE=all
+case "$1" in
+  --bench) MODE=bench; shift ;;
+  --update) MODE=update; shift ;;
+esac
+[ $# = 0 ] || MODE=some
+failed=0
+
+rm -rf "$BUILD"
+mkdir -p "$BUILD/gen"
+cd "$BUILD/gen"
+
+if [ $MODE = all ] || [ $MODE = update ]; then
+  echo "== library warnings"
+  for config in "" "-DSSD1306FUNC_ASYNC_FLUSH=1" "-DSSD1306FUNC_STATS=1" "-DSSD1306FUNC_SCENE_PREFETCH=1" \
+                "-DSSD1306FUNC_WIDTH=128 -DSSD1306FUNC_HEIGHT=64" "-DSSD1306FUNC_SLEEP=0" "-DSSD1306FUNC_SLEEP=1" \
+                "-DSSD1306FUNC_ASYNC_FLUSH=1 -DSSD1306FUNC_SLEEP=0" "-DSSD1306FUNC_ASYNC_FLUSH=1 -DSSD1306FUNC_STATS=1 -DSSD1306FUNC_SCENE_PREFETCH=1"; do
+    if $CXX $FLAGS $WARN $config -c "$ROOT/SSD1306Func.cpp" -o "$BUILD/warnings.o"; then
+      echo "ok   ${config:-default}"
+    else
+      echo "FAIL ${config:-default}"
+      failed=1
+    fi
+  done
+fi
+
+if [ $MODE != some ]; then
+  echo "== benchmark"
+  $CXX $FLAGS $WARN "$TEST/mock/mock.cpp" "$ROOT/SSD1306Func.cpp" "$TEST/bench.cpp" -o "$BUILD/bench"
+  $CXX $FLAGS $WARN -DSSD1306FUNC_ASYNC_FLUSH=1 "$TEST/mock/mock.cpp" "$ROOT/SSD1306Func.cpp" "$TEST/bench.cpp" -o "$BUILD/bench_async"
+  if [ $MODE = update ]; then
+    "$BUILD/bench" golden > "$TEST/golden/bench.txt"
+    echo "wrote golden/bench.txt"
+  fi
+  for bench in bench bench_async; do
+    if "$BUILD/$bench" golden | diff -u "$TEST/golden/bench.txt" - > "$BUILD/$bench.diff"; then
+      echo "ok   $bench"
+    else
+      echo "FAIL $bench: see $BUILD/$bench.diff"
+      failed=1
+    fi
+  done
+  if [ $MODE = bench ]; then
+    "$BUILD/bench"
+    echo "SSD1306FUNC_ASYNC_FLUSH=1:"
+    "$BUILD/bench_async"
+    exit $failed
+  fi
+fi
+
+# Test images and scenes go through the same tools a sketch's would
+rm -f tools.log
+python3 "$TEST/images.py" .
+for image in a b c; do
+  for format in raw rle tiles; do
+    python3 "$TOOLS/ssd1306img.py" $image.pbm --format $format --name ${image}_$format -o ${image}_$format.h 2>> tools.log
+  done
+done
+for frame in 0 1 2 3 4 5; do
+  python3 "$TOOLS/ssd1306img.py" f$frame.pbm --format raw --name f${frame}_raw -o f${frame}_raw.h 2>> tools.log
+done
+python3 "$TOOLS/ssd1306img.py" f0.pbm f1.pbm f2.pbm f3.pbm f4.pbm f5.pbm --format delta --loop --name walk -o walk.h 2>> tools.log
+for script in "$TEST"/data/*.txt; do
+  [ -f "$script" ] || continue
+  name=$(basename "$script" .txt)
+  python3 "$TOOLS/ssd1306scene.py" "$script" --name $name -o $name.h 2>> tools.log
+  python3 "$TOOLS/ssd1306scene.py" "$script" --binary -o $name.bin 2>> tools.log
+done
+
+echo "== tests"
+if [ $MODE = some ]; then
+  tests=$(for name in "$@"; do echo "$TEST/$name.cpp"; done)
+else
+  tests=$(ls "$TEST"/test_*.cpp)
+fi
+# The mocks and the library are built once per set of flags and shared by the tests that use it
+$CXX $FLAGS $WARN $SANITIZE -c "$TEST/mock/mock.cpp" -o "$BUILD/mock.o"
+for test in $tests; do
+  name=$(basename "$test" .cpp)
+  # Each "// flags:" line is one build of the test; without any, it builds once as is
+  variants=$(sed -n 's|^// flags:||p' "$test")
+  [ -n "$variants" ] || variants=" "
+  echo "$variants" | while read -r variant; do
+    key=$(echo "$variant" | tr -c 'A-Za-z0-9\n' _)
+    [ -f "$BUILD/library$key.o" ] || $CXX $FLAGS $WARN $SANITIZE $variant -c "$ROOT/SSD1306Func.cpp" -o "$BUILD/library$key.o"
+    if $CXX $FLAGS $WARN $SANITIZE $variant "$BUILD/mock.o" "$BUILD/library$key.o" "$test" -o "$BUILD/$name$key" &&
+       "$BUILD/$name$key" > "$BUILD/$name$key.log" 2>&1; then
+      echo "ok   $name${variant:+ $variant}"
+    else
+      echo "FAIL $name${variant:+ $variant}: see $BUILD/$name$key.log"
+      exit 1
+    fi
+  done || failed=1
+done
+
+[ $failed = 0 ] && echo "all passed"
+exit $failed
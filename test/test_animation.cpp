@@ -0,0 +1,61 @@
+// A delta animation from tools/ssd1306img.py shows exactly its source frames, looping as asked,
+// and Image frames are XORed over the background.
+#include <initializer_list>
+#include "SSD1306Func.h"
+#include "walk.h"
+#include "f0_raw.h"
+#include "f1_raw.h"
+#include "f2_raw.h"
+#include "f3_raw.h"
+#include "f4_raw.h"
+#include "f5_raw.h"
+
+struct Probe : AnimationEffect {
+  uint16_t getIndex() { return index; }
+};
+
+int main() {
+  const uint8_t* frames[] = {f0_raw, f1_raw, f2_raw, f3_raw, f4_raw, f5_raw};
+  int bad = 0;
+
+  Adafruit_SSD1306 d(128, 64, &Wire), r(128, 64, &Wire);
+  d.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  r.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  d.clearDisplay();
+  flushScreen(&d);
+  g_micros = 0;
+  Probe p;
+  p.begin(&d, walk, 7, 2, 1);
+  int shown = 0;
+  uint16_t last = 0;
+  unsigned long databytes = g_ctl.databytes;
+  while (p.tick(millis())) {
+    // After each frame is drawn, compare against its source; the loop frame leads back to frame 0
+    if (p.getIndex() != last) {
+      last = p.getIndex();
+      int expect = last - 1 == 6 ? 0 : last - 1;
+      r.clearDisplay();
+      Image image = {frames[expect], 128, 64};
+      blitImage(&r, 0, 0, image, 1);
+      finishFlush(&d);
+      if (memcmp(r.getBuffer(), d.getBuffer(), 1024)) { bad++; printf("frame %d drawn wrong\n", last - 1); }
+      if (memcmp(g_ctl.ram, d.getBuffer(), 1024)) { bad++; printf("frame %d not shown\n", last - 1); }
+      shown++;
+    }
+    p.idle();
+  }
+  printf("%d frames in %lums, %lu data bytes\n", shown, millis(), g_ctl.databytes - databytes);
+
+  d.clearDisplay();
+  d.fillRect(0, 60, 128, 4, 1);
+  flushScreen(&d);
+  memcpy(r.getBuffer(), d.getBuffer(), 1024);
+  static const uint8_t box[] = {0xFF, 0x81, 0x81, 0xFF}, diamond[] = {0x18, 0x3C, 0x3C, 0x18};
+  Image images[] = {{box, 8, 4}, {diamond, 8, 4}};
+  playAnimation(&d, images, 2, 50, 30, 58, 3);
+  blitImage(&r, 30, 58, images[1], 2);
+  if (memcmp(r.getBuffer(), d.getBuffer(), 1024)) { bad++; printf("Image frames not over the background\n"); }
+
+  printf("bad=%d\n", bad);
+  return bad != 0;
+}
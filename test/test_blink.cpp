@@ -0,0 +1,45 @@
+// The CTC indicator blinks only its own bytes and restores the screen and cursor afterwards.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+int main() {
+  int fails = 0;
+  for (int h : {64, 32}) for (int rot = 0; rot < 4; rot++) for (int size : {1, 2}) {
+    Adafruit_SSD1306 d(128, h, &Wire);
+    d.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+    d.setRotation(rot);
+    uint32_t seed = rot * 7 + h;
+    for (int i = 0; i < 128 * h / 8; i++) { seed = seed * 1103515245u + 12345u; d.getBuffer()[i] = seed >> 16; }
+    d.setTextSize(size);
+    d.setCursor(3, 9);
+    flushScreen(&d);
+    static uint8_t original[1024];
+    memcpy(original, d.getBuffer(), 128 * h / 8);
+
+    g_micros = 0;
+    g_serial_at = 1800;
+    CtcEffect e;
+    e.begin(&d, CTC_SERIAL, false, 0);
+    int changed = 0;
+    bool checked = false;
+    while (e.tick(millis())) {
+      // Halfway through the first blink: the indicator is showing
+      if (!checked && millis() >= 700) {
+        checked = true;
+        for (int i = 0; i < 128 * h / 8; i++) if (original[i] != d.getBuffer()[i]) changed++;
+        if (memcmp(g_ctl.ram, d.getBuffer(), 128 * h / 8)) { fails++; printf("indicator not flushed\n"); }
+      }
+      e.idle();
+    }
+
+    bool restored = !memcmp(original, d.getBuffer(), 128 * h / 8);
+    bool cursor = d.getCursorX() == 3 && d.getCursorY() == 9;
+    bool shown = !memcmp(g_ctl.ram, d.getBuffer(), 128 * h / 8);
+    if (!restored || !cursor || !shown || changed == 0 || changed > 16) {
+      fails++;
+      printf("h=%d rot=%d size=%d changed bytes=%d restored=%d cursor=%d shown=%d\n", h, rot, size, changed, restored, cursor, shown);
+    }
+  }
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
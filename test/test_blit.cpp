@@ -0,0 +1,37 @@
+// blitImage from every source type against drawBitmap, on every rotation and all three colors.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+static void reader(void* context, uint32_t offset, uint8_t* dest, uint16_t count) {
+  memcpy(dest, (uint8_t*)context + offset, count);
+}
+
+int main() {
+  Adafruit_SSD1306 a(128, 64, &Wire), b(128, 64, &Wire);
+  a.begin(); b.begin();
+  static uint8_t bits[40 * 200];
+  uint32_t seed = 5;
+  int bad = 0;
+  for (int t = 0; t < 3000; t++) {
+    for (unsigned i = 0; i < sizeof(bits); i++) { seed = seed * 1103515245u + 12345u; bits[i] = seed >> 16; }
+    int w = 1 + (seed >> 3) % 200, h = 1 + (seed >> 11) % 150;
+    int x = (int)((seed >> 5) % 300) - 150, y = (int)((seed >> 13) % 250) - 125, color = t % 3;
+    memcpy(a.getBuffer(), bits + 100, 1024);
+    memcpy(b.getBuffer(), bits + 100, 1024);
+    int rot = (t / 3) % 4;
+    a.setRotation(rot); b.setRotation(rot);
+
+    Image image = {bits, w, h};
+    RamImageSource ram(bits, w, h);
+    StreamImageSource stream(reader, bits, w, h);
+    a.drawBitmap(x, y, (const uint8_t*)bits, w, h, color);
+    if (t % 3 == 0) blitImage(&b, x, y, image, color);
+    else if (t % 3 == 1) blitImage(&b, x, y, ram, color);
+    else blitImage(&b, x, y, stream, color);
+    if (memcmp(a.getBuffer(), b.getBuffer(), 1024)) {
+      if (++bad < 5) printf("w=%d h=%d x=%d y=%d color=%d rot=%d\n", w, h, x, y, color, rot);
+    }
+  }
+  printf("bad=%d\n", bad);
+  return bad != 0;
+}
@@ -0,0 +1,76 @@
+// flags:
+// flags: -D__AVR__ -DSSD1306FUNC_SLEEP=0
+// Bus clocks and transactions: setBusClock() reports the clock the hardware divides down to and the
+// display's transfers run at it, and a partial flush opens its window in one command transaction.
+#include "SSD1306Func.h"
+
+// Reaches the display's SPI state, so the same mock can stand in for an SPI panel
+struct SpiDisplay : Adafruit_SSD1306 {
+  SpiDisplay() : Adafruit_SSD1306(128, 64, &Wire) {}
+  void useSpi() { wire = NULL; spi = &SPI; }
+  uint32_t spiClock() { return spiSettings.clock; }
+};
+
+// The library keeps per-display state for SSD1306FUNC_MAX_DISPLAYS displays, so every case reuses these two
+static Adafruit_SSD1306 d(128, 64, &Wire);
+static SpiDisplay s;
+static int fails = 0;
+
+static void expect(const char* what, uint32_t hz, uint32_t got, uint32_t want) {
+  printf("%-5s %7lu Hz -> %7lu Hz\n", what, (unsigned long)hz, (unsigned long)got);
+  if (got != want) { printf("      expected %lu\n", (unsigned long)want); fails++; }
+}
+
+int main() {
+  d.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  s.begin(SSD1306_SWITCHCAPVCC, 0x3D);
+  s.useSpi();
+
+#if defined(__AVR__)
+  // The TWI runs at F_CPU / (16 + 2 * TWBR), and TWBR stops at 255
+  static const uint32_t wire[][2] = {{400000, 400000}, {1000000, 1000000}, {300000, 307692}, {10000, 30418}, {8000000, 1000000}};
+  // SPI divides F_CPU by 2 to 128, never running faster than asked
+  static const uint32_t spi[][2] = {{8000000, 8000000}, {20000000, 8000000}, {5000000, 4000000}, {100000, 125000}, {1000, 125000}};
+#else
+  // Other cores take the clock as asked
+  static const uint32_t wire[][2] = {{400000, 400000}, {1000000, 1000000}, {300000, 300000}};
+  static const uint32_t spi[][2] = {{8000000, 8000000}, {5000000, 5000000}};
+#endif
+  for (unsigned i = 0; i < sizeof(wire) / sizeof(wire[0]); i++) expect("wire", wire[i][0], setBusClock(&d, wire[i][0]), wire[i][1]);
+  for (unsigned i = 0; i < sizeof(spi) / sizeof(spi[0]); i++) {
+    uint32_t got = setBusClock(&s, spi[i][0]);
+    expect("spi", spi[i][0], got, spi[i][1]);
+    if (s.spiClock() != got) { printf("      but the SPI settings hold %lu\n", (unsigned long)s.spiClock()); fails++; }
+  }
+  expect("zero", 0, setBusClock(&d, 0), 0);
+
+  // The display's own transfers run at the clock set, and the bus goes back to its own speed afterwards
+  setBusClock(&d, 1000000);
+  d.clearDisplay();
+  unsigned long start = micros();
+  d.display();
+  unsigned long took = micros() - start;
+  printf("flush at 1 MHz took %luus, bus left at %lu Hz\n", took, (unsigned long)Wire.getClock());
+  // 1024 data bytes and the window commands at 9 clocks per byte, with the address byte of each transaction
+  if (took < 9 * 1024 || took > 9 * 1200 || Wire.getClock() != 100000) fails++;
+
+  // A partial flush sends its 6 window commands in one transaction, then the data, 31 bytes to a transaction after the control byte
+  static const int16_t rects[][4] = {{10, 3, 20, 4}, {10, 3, 20, 12}, {0, 16, 128, 8}};
+  static const uint32_t sent[][3] = {{2, 6, 20}, {3, 6, 40}, {6, 6, 128}};
+  setBusClock(&d, 400000);
+  for (unsigned i = 0; i < sizeof(rects) / sizeof(rects[0]); i++) {
+    d.fillRect(rects[i][0], rects[i][1], rects[i][2], rects[i][3], SSD1306_WHITE);
+    markDirty(&d, rects[i][0], rects[i][1], rects[i][2], rects[i][3]);
+    uint32_t transactions = Wire.transactions, commands = g_ctl.commands, databytes = g_ctl.databytes;
+    flushDirty(&d);
+    transactions = Wire.transactions - transactions;
+    commands = g_ctl.commands - commands;
+    databytes = g_ctl.databytes - databytes;
+    printf("partial flush %dx%d: %lu transactions, %lu commands, %lu data bytes\n", rects[i][2], rects[i][3],
+           (unsigned long)transactions, (unsigned long)commands, (unsigned long)databytes);
+    if (transactions != sent[i][0] || commands != sent[i][1] || databytes != sent[i][2] || memcmp(g_ctl.ram, d.getBuffer(), 1024)) fails++;
+  }
+
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
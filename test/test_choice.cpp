@@ -0,0 +1,84 @@
+// Choice menus: serial moves and digit picks, debounced GPIO buttons with the confirm button held
+// at the start, and scene branches on the choice.
+#include <initializer_list>
+#include "SSD1306Func.h"
+#include "branch.h"
+
+static const char* options[] = {"Alpha", "Beta", "Gamma", "Delta", "Epsilon", "Zeta", "Eta", "Theta"};
+
+// A highlighted row is inverted from margin to margin
+static bool isInverted(Adafruit_SSD1306& d, int row) {
+  return d.getBuffer()[(2 + row) * 128] == 0xFF && d.getBuffer()[(2 + row) * 128 + 127] == 0xFF;
+}
+
+int main() {
+  Adafruit_SSD1306 a(128, 64, &Wire);
+  a.begin();
+  int bad = 0;
+
+  // Serial: "n" twice then an empty line picks option 2. The LF after a CR and the one ending
+  // "n" must not confirm.
+  g_key_gap = 5;
+  g_serial_at = 0;
+  g_serial_keys = "";
+  ChoiceEffect e;
+  e.begin(&a, CTC_SERIAL, 0, options, 3);
+  flushScreen(&a);
+  if (!isInverted(a, 0) || isInverted(a, 1)) { bad++; printf("first option not highlighted\n"); }
+  g_serial_keys = "n\r\nn\n\n";
+  g_serial_at = g_micros / 1000;
+  unsigned long movebytes = 0, databytes = g_ctl.databytes;
+  int choice = 0;
+  while (e.tick(millis())) {
+    g_micros += 1000;
+    if (e.getChoice() != choice) { movebytes = g_ctl.databytes - databytes; choice = e.getChoice(); }
+    databytes = g_ctl.databytes;
+  }
+  finishFlush(&a);
+  if (e.getChoice() != 2) { bad++; printf("serial picked %d\n", e.getChoice()); }
+  if (!isInverted(a, 2) || isInverted(a, 0) || isInverted(a, 1)) { bad++; printf("highlight did not follow\n"); }
+  if (memcmp(g_ctl.ram, a.getBuffer(), 1024)) { bad++; printf("menu not shown\n"); }
+  printf("a move sends %lu bytes\n", movebytes);
+
+  // A digit jumps to its option, scrolling the list: 8 options on 6 rows
+  g_serial_keys = "";
+  e.begin(&a, CTC_SERIAL, 0, options, 8);
+  g_serial_keys = "8\n\n";
+  g_serial_at = g_micros / 1000;
+  while (e.tick(millis())) g_micros += 1000;
+  if (e.getChoice() != 7 || !isInverted(a, 5)) { bad++; printf("digit picked %d\n", e.getChoice()); }
+
+  // GPIO: next on pin 3, confirm on pin 4, which is still held from before
+  g_serial_keys = "";
+  g_pinlevel[4] = HIGH;
+  e.begin(&a, 4, 3, options, 8);
+  for (int t = 0; t < 2000 && e.tick(millis()); t++) {
+    g_micros += 1000;
+    if (t == 10) g_pinlevel[4] = LOW;
+    for (int k = 0; k < 7; k++) {
+      if (t == 50 + k * 60) g_pinlevel[3] = HIGH;
+      if (t == 80 + k * 60) g_pinlevel[3] = LOW;
+    }
+    // A bounce on the first press
+    if (t == 53) g_pinlevel[3] = LOW;
+    if (t == 54) g_pinlevel[3] = HIGH;
+    if (t == 600) g_pinlevel[4] = HIGH;
+  }
+  if (e.getChoice() != 7) { bad++; printf("gpio picked %d\n", e.getChoice()); }
+
+  // The scene branches to "Right", which ends at once; "Left" would wait 3 s
+  g_serial_keys = "";
+  a.clearDisplay();
+  g_key_gap = 50;
+  SceneEffect s;
+  s.begin(&a, branch, NULL, 0);
+  g_serial_keys = "\n\n2\n\n";
+  g_serial_at = g_micros / 1000;
+  unsigned long start = millis();
+  while (s.tick(millis())) g_micros += 100;
+  unsigned long took = millis() - start;
+  if (!isInverted(a, 1) || took > 1000) { bad++; printf("scene took %lums, rows %d %d %d\n", took, isInverted(a, 0), isInverted(a, 1), isInverted(a, 2)); }
+
+  printf("bad=%d\n", bad);
+  return bad != 0;
+}
@@ -0,0 +1,88 @@
+// Cross fades between two images of different sizes: every mask step moves its pixels from the
+// old image to the new one, pixels outside the union stay, and the panel shows the result.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+static uint8_t tiles[4 * 8];
+
+// The step at which the mask turns a pixel over, or 99 for never
+static int getMaskStep(const FadeMask& m, int x, int y) {
+  if (m.tiles) {
+    for (int s = 0; s < m.steps; s++) if (m.tiles[s * 8 + (x & 7)] & (1 << (y & 7))) return s;
+    return 99;
+  }
+  return ((m.dx * x + m.dy * y) % m.steps + m.steps) % m.steps;
+}
+
+static bool getBit(const uint8_t* bits, int w, int h, int x, int y) {
+  if (x < 0 || y < 0 || x >= w || y >= h) return false;
+  return bits[y * ((w + 7) / 8) + x / 8] & (0x80 >> (x & 7));
+}
+
+int main() {
+  Adafruit_SSD1306 a(128, 64, &Wire), r(128, 64, &Wire);
+  a.begin(); r.begin();
+  uint32_t seed = 11;
+  int bad = 0, runs = 0;
+  auto rnd = [&]() { seed = seed * 1103515245u + 12345u; return seed >> 8; };
+  static uint8_t from[24 * 80], to[24 * 80];
+  // A tile mask that splits each 8x8 block over 4 steps
+  for (int c = 0; c < 8; c++) for (int b = 0; b < 8; b++) tiles[((c * 3 + b * 5) % 4) * 8 + c] |= 1 << b;
+
+  uint8_t* fb = a.getBuffer();
+  for (int t = 0; t < 300; t++) {
+    int rot = rnd() % 4;
+    a.setRotation(rot); r.setRotation(rot);
+    int fw = 1 + rnd() % 140, fh = 1 + rnd() % 70, tw = 1 + rnd() % 140, th = 1 + rnd() % 70;
+    for (uint8_t& v : from) v = rnd();
+    for (uint8_t& v : to) v = rnd();
+    int x = (int)(rnd() % 100) - 20, y = (int)(rnd() % 60) - 20;
+    FadeMask m;
+    if (rnd() % 3 == 0) m = {tiles, 4, 0, 0};
+    else m = {NULL, (uint16_t)(1 + rnd() % 5), (int8_t)(rnd() % 3 - 1), (int8_t)(rnd() % 3 - 1)};
+    for (int i = 0; i < 1024; i++) fb[i] = rnd();
+    RamImageSource source(from, fw, fh), dest(to, tw, th);
+    // Half the runs start with the old image already on screen
+    if (rnd() % 2) {
+      a.fillRect(x, y, max(fw, tw), max(fh, th), 0);
+      blitImage(&a, x, y, source, 1);
+    }
+    flushScreen(&a);
+    memcpy(r.getBuffer(), fb, 1024);
+
+    CrossFadeEffect e;
+    e.begin(&a, m, 10, x, y, source, dest);
+    while (e.tick(millis())) g_micros += 1000;
+    finishFlush(&a);
+
+    int w = max(fw, tw), h = max(fh, th);
+    for (int py = 0; py < a.height(); py++) for (int px = 0; px < a.width(); px++) {
+      bool inside = px >= x && py >= y && px < x + w && py < y + h;
+      bool want = !inside ? r.getPixel(px, py) : getMaskStep(m, px, py) < m.steps ? getBit(to, tw, th, px - x, py - y) : getBit(from, fw, fh, px - x, py - y);
+      if (a.getPixel(px, py) != want) {
+        if (++bad < 5) printf("t=%d rot=%d pixel %d,%d mask %d/%d/%d,%d\n", t, rot, px, py, m.tiles != NULL, m.steps, m.dx, m.dy);
+        py = a.height();
+        break;
+      }
+    }
+    if (memcmp(g_ctl.ram, fb, 1024)) { bad++; printf("t=%d not shown\n", t); }
+    runs++;
+  }
+
+  // A full-screen change in 4 steps of 40ms, the old image already shown
+  a.setRotation(0);
+  static uint8_t screen1[128 * 8], screen2[128 * 8];
+  for (uint8_t& v : screen1) v = rnd();
+  for (uint8_t& v : screen2) v = rnd();
+  Image image1 = {screen1, 128, 64}, image2 = {screen2, 128, 64};
+  a.clearDisplay();
+  blitImage(&a, 0, 0, image1, 1);
+  flushScreen(&a);
+  unsigned long start = millis();
+  FadeMask quarters = {tiles, 4, 0, 0};
+  crossFadeImages(&a, quarters, 40, 0, 0, image1, image2);
+  printf("full-screen cross fade took %lums\n", millis() - start);
+
+  printf("runs=%d bad=%d\n", runs, bad);
+  return bad != 0;
+}
@@ -0,0 +1,92 @@
+// flags:
+// flags: -DSSD1306FUNC_SLEEP=1
+// CTC button handling: debounced presses, bounces, glitches, a button held from the start, the
+// confirm callback (also while the button is held), a sketch's own interrupt handler on the
+// button, and two waits at once.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+// The library keeps per-display state for SSD1306FUNC_MAX_DISPLAYS displays, so every case reuses these two
+static Adafruit_SSD1306 a(128, 64, &Wire), b(128, 64, &Wire);
+static bool callbackresult;
+static bool callback() { return callbackresult; }
+static int sketchedges = 0;
+static void sketchIsr() { sketchedges++; }
+
+// Runs a CTC while `level` scripts the pin; returns the ms it took, or -1 past `limit`
+template <class F> long run(uint8_t pin, bool timed, long timer, F level, long limit = 20000) {
+  g_micros = 0;
+  CtcEffect e;
+  e.begin(&a, pin, timed, timer);
+  while (e.tick(millis())) {
+    unsigned long t = g_micros / 1000;
+    if ((long)t > limit) return -1;
+    int newlevel = level(t);
+    if (newlevel != g_pinlevel[pin]) {
+      g_pinlevel[pin] = newlevel;
+      if (pin < 4 && g_isr[pin]) g_isr[pin]();
+    }
+    e.idle();
+  }
+  return g_micros / 1000;
+}
+
+static int fails = 0;
+
+static void expect(const char* what, long took, long from, long to) {
+  printf("%-32s %ldms\n", what, took);
+  if (took < from || took > to) { fails++; printf("  expected %ld to %ldms\n", from, to); }
+}
+
+int main() {
+  g_serial_at = ~0UL;
+  a.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  b.begin(SSD1306_SWITCHCAPVCC, 0x3D);
+  for (uint8_t pin : {2, 9}) {
+    printf("pin %d\n", pin);
+    expect("press at 100", run(pin, false, 0, [](unsigned long t) { return t >= 100; }), 100, 140);
+    expect("bounces 100 to 110, then held", run(pin, false, 0, [](unsigned long t) { return t >= 110 ? 1 : t >= 100 ? (int)(t & 1) : 0; }), 110, 150);
+    expect("5ms glitch, timer 1000", run(pin, true, 1000, [](unsigned long t) { return t >= 100 && t < 105; }), 1000, 1100);
+    expect("held until 200, press at 500", run(pin, false, 0, [](unsigned long t) { return t < 200 || t >= 500; }), 500, 600);
+  }
+
+  setConfirmCallback(callback);
+  callbackresult = true;
+  expect("confirm callback", run(9, false, 0, [](unsigned long) { return 0; }, 100), 0, 5);
+  expect("confirm callback, button held", run(9, false, 0, [](unsigned long) { return 1; }, 100), 0, 5);
+  setConfirmCallback(NULL);
+
+  // The sketch's handler on the button stays attached through the wait and after it
+  g_pinlevel[2] = LOW;
+  attachInterrupt(digitalPinToInterrupt(2), sketchIsr, CHANGE);
+  expect("press at 100, sketch handler", run(2, false, 0, [](unsigned long t) { return t >= 100; }), 100, 140);
+  printf("sketch handler %s, %d edges\n", g_isr[2] == sketchIsr ? "kept" : "LOST", sketchedges);
+  if (g_isr[2] != sketchIsr || sketchedges != 1) fails++;
+  detachInterrupt(digitalPinToInterrupt(2));
+
+  // Two waits on two displays each debounce their own button
+  g_pinlevel[2] = g_pinlevel[3] = LOW;
+  g_micros = 0;
+  CtcEffect e1, e2;
+  e1.begin(&a, 2, false, 0);
+  e2.begin(&b, 3, false, 0);
+  long done1 = -1, done2 = -1;
+  while ((done1 < 0 || done2 < 0) && g_micros < 20000000UL) {
+    unsigned long t = g_micros / 1000;
+    g_pinlevel[2] = t >= 300;
+    g_pinlevel[3] = (t >= 100 && t < 103) || t >= 150;   // A glitch, then a press
+    if (done1 < 0 && !e1.tick(millis())) done1 = t;
+    if (done2 < 0 && !e2.tick(millis())) done2 = t;
+    yield();
+    g_micros += 500;
+  }
+  expect("two waits, press at 300", done1, 300, 340);
+  expect("two waits, glitch, press at 150", done2, 150, 190);
+
+  g_pinlevel[9] = LOW;
+  g_micros = 0;
+  ctcTimed(&a, 9, 700);
+  expect("ctcTimed 700", g_micros / 1000, 700, 800);
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
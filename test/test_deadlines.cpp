@@ -0,0 +1,78 @@
+// flags: -DSSD1306FUNC_STATS=1
+// Frame deadlines: a fade and a scroll whose frames take longer to send than their delay merge the
+// late frames, keep their duration and end on the same screen as an unhurried run. A wait of 0
+// restarts the schedule instead of leaving frames to catch up on.
+#include "SSD1306Func.h"
+
+// The library keeps per-display state for SSD1306FUNC_MAX_DISPLAYS displays, so every case reuses these two
+static Adafruit_SSD1306 a(128, 64, &Wire), r(128, 64, &Wire);
+static int fails = 0;
+
+// Runs `e` to the end and returns the ms it took
+static unsigned long run(SSD1306Effect& e) {
+  unsigned long start = millis();
+  runEffect(e);
+  return millis() - start;
+}
+
+// Compares a late run on `a` with an unhurried one on `r`; the late run went out last, so the controller RAM is `a`'s
+static void compare(const char* what, SSD1306Effect& late, unsigned long took, SSD1306Effect& slow, unsigned long ideal) {
+  EffectStats l = late.getStats(), s = slow.getStats();
+  bool same = !memcmp(a.getBuffer(), r.getBuffer(), 1024), shown = !memcmp(g_ctl.ram, a.getBuffer(), 1024);
+  printf("%-8s %lums (ideal %lums), %u frames, %u merged; unhurried %u frames, %u merged; %s, %s\n", what, took, ideal,
+         l.frames, l.mergedFrames, s.frames, s.mergedFrames, same ? "same screen" : "SCREENS DIFFER", shown ? "ram=buf" : "RAM!=BUF");
+  // One full-screen flush takes about 25 ms at 400 kHz; the late run may end on one, but does not add one per frame
+  if (took < ideal || took > ideal + 60 || l.frames != s.frames || !l.mergedFrames || s.mergedFrames || !same || !shown) fails++;
+}
+
+// Polls for 100 ms, then waits 10 ms three times
+struct Poller : SSD1306Effect {
+  unsigned long times[3];
+  uint8_t count;
+  void begin(Adafruit_SSD1306* display) { count = 0; start(display); }
+  long step() {
+    if (millis() < 100) return 0;
+    if (count == 3) return EFFECT_DONE;
+    times[count++] = millis();
+    return 10;
+  }
+};
+
+int main() {
+  a.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  r.begin(SSD1306_SWITCHCAPVCC, 0x3D);
+
+  // A dissolve step redraws the whole screen, so at 2 ms per step every frame is late
+  FadeDissolveEffect slowfade, fade;
+  r.clearDisplay(); slowfade.begin(&r, 100, 1); run(slowfade);
+  a.clearDisplay(); fade.begin(&a, 2, 1);
+  unsigned long took = run(fade);
+  compare("fade", fade, took, slowfade, fade.getStats().frames * 2);
+
+  // A one-row scroll step shifts the whole screen, so at 1 ms per row every frame is late
+  static uint8_t bits[16 * 200];
+  uint32_t seed = 5;
+  for (unsigned i = 0; i < sizeof(bits); i++) bits[i] = (seed = seed * 1103515245u + 12345u) >> 16;
+  Image image = {bits, 128, 200};
+  VerticalScrollEffect slowscroll, scroll;
+  slowscroll.begin(&r, 0, 0, 100, 1, false, false, 0, 0, 0, image); run(slowscroll);
+  scroll.begin(&a, 0, 0, 1, 1, false, false, 0, 0, 0, image);
+  took = run(scroll);
+  compare("scroll", scroll, took, slowscroll, 200 - 64);
+
+  // After polling, the waits count from the last poll, not from when polling began, so none of them is already late
+  g_micros = 0;
+  Poller poller;
+  poller.begin(&a);
+  run(poller);
+  EffectStats stats = poller.getStats();
+  printf("poll     waits at %lu, %lu, %lums, %u merged\n", poller.times[0], poller.times[1], poller.times[2], stats.mergedFrames);
+  if (poller.times[0] < 100 || poller.times[0] > 102 || stats.mergedFrames) fails++;
+  for (int i = 1; i < 3; i++) {
+    long gap = poller.times[i] - poller.times[i - 1];
+    if (gap < 9 || gap > 12) fails++;
+  }
+
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
@@ -0,0 +1,22 @@
+// A 64x48 panel is flushed into the centre of the 128x64 GDDRAM, as the controller maps it.
+// flags:
+// flags: -DSSD1306FUNC_WIDTH=64 -DSSD1306FUNC_HEIGHT=48
+#include "SSD1306Func.h"
+
+int main() {
+  Adafruit_SSD1306 d(64, 48, &Wire);
+  d.begin();
+  int fails = 0;
+  memset(&g_ctl.ram, 0xEE, sizeof(g_ctl.ram));
+  for (int i = 0; i < 64 * 6; i++) d.getBuffer()[i] = i * 7 + 1;
+  flushScreen(&d);
+  for (int p = 0; p < 6; p++) for (int c = 0; c < 64; c++) if (g_ctl.ram[p][c + 32] != (uint8_t)((p * 64 + c) * 7 + 1)) fails++;
+  if (g_ctl.ram[0][31] != 0xEE || g_ctl.ram[0][96] != 0xEE) fails++;
+
+  d.getBuffer()[64 * 2 + 10] = 0x55;
+  markDirty(&d, 10, 16, 1, 8);
+  flushDirty(&d);
+  if (g_ctl.ram[2][42] != 0x55) fails++;
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
@@ -0,0 +1,83 @@
+// Grayscale images: ordered dithering against a per-pixel Bayer reference, and temporal frames
+// that add up to each pixel's level over one cycle.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+static const uint8_t BAYER[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+int main() {
+  uint32_t seed = 21;
+  int bad = 0;
+  auto rnd = [&]() { seed = seed * 1103515245u + 12345u; return seed >> 8; };
+  static uint8_t levels[200 * 100];
+  for (int t = 0; t < 600; t++) {
+    uint8_t bits = (rnd() % 2) ? 2 : 4;
+    int w = 1 + rnd() % 150, h = 1 + rnd() % 80;
+    for (uint8_t& b : levels) b = rnd();
+    GrayImage image = {levels, w, h, bits};
+    int x = (int)(rnd() % 180) - 40, y = (int)(rnd() % 100) - 30, rot = (rnd() % 4) ? 0 : rnd() % 4;
+    Adafruit_SSD1306 a(128, 64, &Wire), r(128, 64, &Wire);
+    a.begin(); r.begin();
+    for (int i = 0; i < 1024; i++) a.getBuffer()[i] = r.getBuffer()[i] = rnd();
+    a.setRotation(rot); r.setRotation(rot);
+
+    drawDitheredImage(&a, x, y, image);
+    int rowbytes = (w * bits + 7) / 8, top = (1 << bits) - 1;
+    auto level = [&](int ix, int iy) { int bit = ix * bits; return (levels[iy * rowbytes + bit / 8] >> (8 - bits - bit % 8)) & top; };
+    for (int iy = 0; iy < h; iy++) for (int ix = 0; ix < w; ix++) {
+      int sx = x + ix, sy = y + iy;
+      if (sx < 0 || sy < 0 || sx >= r.width() || sy >= r.height()) continue;
+      r.drawPixel(sx, sy, level(ix, iy) * 16 > BAYER[sy & 3][sx & 3] * top);
+    }
+    if (memcmp(a.getBuffer(), r.getBuffer(), 1024)) { if (++bad < 4) printf("dither t=%d rot=%d\n", t, rot); }
+
+    // Temporal: count the frames each pixel is on over one cycle, weighted by contrast plane
+    if (t % 10 == 0) {
+      bool contrast = t % 20 == 0;
+      Adafruit_SSD1306 g(128, 64, &Wire);
+      g.begin();
+      GrayscaleEffect e;
+      e.begin(&g, 0, 0, contrast, x, y, image);
+      int cycle = contrast ? bits : top;
+      static int counts[64][128];
+      memset(counts, 0, sizeof(counts));
+      for (int f = 0; f < cycle; f++) {
+        e.tick(millis());
+        for (int sy = 0; sy < 64; sy++) for (int sx = 0; sx < 128; sx++) if (g.getPixel(sx, sy)) counts[sy][sx] += contrast ? 1 << (bits - 1 - f) : 1;
+      }
+      bool same = true;
+      for (int iy = 0; iy < h && same; iy++) for (int ix = 0; ix < w && same; ix++) {
+        int sx = x + ix, sy = y + iy;
+        if (sx < 0 || sy < 0 || sx >= 128 || sy >= 64) continue;
+        if (counts[sy][sx] != level(ix, iy)) {
+          same = false;
+          if (++bad < 6) printf("temporal t=%d contrast=%d at %d,%d: %d instead of %d\n", t, contrast, sx, sy, counts[sy][sx], level(ix, iy));
+        }
+      }
+      e.stop();
+    }
+  }
+
+  // A timed run ends on the dithered image
+  Adafruit_SSD1306 g(128, 64, &Wire), r(128, 64, &Wire);
+  g.begin(); r.begin();
+  GrayImage image = {levels, 40, 20, 2};
+  unsigned long start = millis();
+  drawGrayscaleImage(&g, 300, -1, false, 3, 5, image);
+  unsigned long took = millis() - start;
+  drawDitheredImage(&r, 3, 5, image);
+  if (memcmp(g.getBuffer(), r.getBuffer(), 1024) || took < 300 || took > 360) { bad++; printf("timed run took %lums\n", took); }
+
+  // With contrast planes, the most significant plane shows at full contrast, and the run ends at the begin() contrast
+  GrayscaleEffect planes;
+  planes.begin(&g, 0, 0, true, 3, 5, image);
+  planes.tick(millis());
+  if (g_ctl.contrast != 0xFF) { bad++; printf("first plane at contrast %02x\n", g_ctl.contrast); }
+  planes.stop();
+  g_ctl.contrast = 0x10;
+  drawGrayscaleImage(&g, 300, -1, true, 3, 5, image);
+  if (g_ctl.contrast != 0xCF) { bad++; printf("contrast plane run ended at %02x\n", g_ctl.contrast); }
+
+  printf("bad=%d\n", bad);
+  return bad != 0;
+}
@@ -0,0 +1,55 @@
+// The hardware scroller shows the right bitmap rows through the start line on every frame and
+// leaves the RAM linear, start line 0, when done.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+static uint8_t bits[13 * 200];
+
+struct Probe : HardwareScrollEffect {
+  // Pixels on the panel, seen through the start line, that differ from the bitmap at `position`
+  int check(const Image& bmp, int h) {
+    int bad = 0;
+    for (int y = 0; y < h; y++) for (int x = 0; x < 128; x++) {
+      int row = (y + g_ctl.startline) & 63;
+      int got = (g_ctl.ram[row / 8][x] >> (row & 7)) & 1;
+      int ix = x - offset_x, iy = y + position, want = 0;
+      if (ix >= 0 && ix < bmp.width && iy >= 0 && iy < bmp.height) want = (bmp.bitmap[iy * ((bmp.width + 7) / 8) + ix / 8] >> (7 - (ix & 7))) & 1;
+      if (got != want) bad++;
+    }
+    return bad;
+  }
+  int getPosition() { return position; }
+};
+
+static int run(int h, int step, int offx, int endy) {
+  Adafruit_SSD1306 d(128, h, &Wire);
+  d.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  Image bmp = {bits, 100, 200};
+  Probe p;
+  p.begin(&d, 10, 10, 5, step, offx, endy, bmp);
+  int bad = 0, frames = 0;
+  unsigned long bytes = Wire.bytes;
+  while (p.isRunning()) {
+    g_micros += 100000;
+    p.tick(millis());
+    frames++;
+    if (p.isRunning()) bad += p.check(bmp, h);
+  }
+
+  bool same = true;
+  for (int page = 0; page < h / 8; page++) if (memcmp(g_ctl.ram[page], d.getBuffer() + page * 128, 128)) same = false;
+  if (bad || !same || g_ctl.startline) {
+    printf("h=%d step=%d offx=%d endy=%d frames=%d bad=%d pos=%d sl=%d same=%d bytes/frame=%lu\n", h, step, offx, endy, frames, bad, p.getPosition(),
+           g_ctl.startline, same, (Wire.bytes - bytes) / frames);
+  }
+  return bad + !same + (g_ctl.startline != 0);
+}
+
+int main() {
+  uint32_t seed = 7;
+  for (uint8_t& b : bits) { seed = seed * 1103515245u + 12345u; b = seed >> 16; }
+  int fails = 0;
+  for (int h : {64, 32, 16}) for (int step : {1, 3, 7, 8, 13, 40, 70, -1, -5, -9, -64, -100}) for (int offx : {0, 14, -9}) for (int endy : {0, 11}) fails += run(h, step, offx, endy);
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
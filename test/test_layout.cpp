@@ -0,0 +1,84 @@
+// Dialog word wrap and paging against a greedy reference wrap at 21 characters per line.
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include "SSD1306Func.h"
+
+struct Probe : DialogTextEffect {
+  int getPhase() { return phase; }
+  int getIndex() { return index; }
+  bool isAtCtc() { return phase == DIALOG_PAGE_CTC || phase == DIALOG_END_CTC; }
+  bool isAtPageCtc() { return phase == DIALOG_PAGE_CTC; }
+};
+
+static std::vector<std::string> wrap(const std::string& text, size_t columns) {
+  std::vector<std::string> lines;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    std::string line;
+    size_t start = pos, lastspace = std::string::npos;
+    while (pos < text.size() && text[pos] != '\n') {
+      if (line.size() + 1 > columns && pos > start) {
+        // Break at the last space, unless the word fills the whole line
+        if (text[pos] != ' ' && lastspace != std::string::npos && lastspace > start) { line = text.substr(start, lastspace - start); pos = lastspace; }
+        break;
+      }
+      if (text[pos] == ' ') lastspace = pos;
+      line += text[pos++];
+    }
+    lines.push_back(line);
+    if (pos < text.size() && text[pos] == '\n') pos++;
+    else while (pos < text.size() && text[pos] == ' ') pos++;
+  }
+  return lines;
+}
+
+int main() {
+  Adafruit_SSD1306 d(128, 64, &Wire), r(128, 64, &Wire);
+  d.begin(); r.begin();
+  int fails = 0;
+  std::string text = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\n"
+                     "Ut enim ad minim veniam, quis nostrud exercitationullamcolaborisnisiutaliquipexeacommodo consequat. Duis aute irure dolor in "
+                     "reprehenderit in voluptate velit esse cillum.";
+  std::vector<std::string> lines = wrap(text, 21);
+
+  for (int onebyone = 0; onebyone < 2; onebyone++) {
+    g_micros = 0;
+    g_serial_at = ~0UL;
+    d.clearDisplay();
+    d.setTextColor(SSD1306_WHITE);
+    Probe p;
+    p.begin(&d, 2, 5, 0, 0, 0, 0, onebyone, "Head", text.c_str());
+    size_t line = 0;
+    int pages = 0;
+    for (;;) {
+      for (int guard = 0; !p.isAtCtc(); guard++) {
+        if (!p.tick(millis())) break;
+        g_micros += 1000;
+        if (guard > 5000) { printf("stuck in phase %d\n", p.getPhase()); return 1; }
+      }
+
+      r.clearDisplay();
+      r.setTextColor(SSD1306_WHITE);
+      r.setCursor(0, 0);
+      r.print("Head");
+      for (int row = 0; row < 6 && line < lines.size(); row++, line++) { r.setCursor(0, 16 + row * 8); r.print(lines[line].c_str()); }
+      pages++;
+      if (memcmp(d.getBuffer() + 128 * 2, r.getBuffer() + 128 * 2, 128 * 6)) { fails++; printf("page %d differs (onebyone=%d)\n", pages, onebyone); }
+      if (!p.isAtPageCtc()) break;
+
+      // Confirm the page and wait for the next one to start
+      g_serial_at = millis();
+      int index = p.getIndex();
+      for (int guard = 0; p.isAtPageCtc() && p.getIndex() == index; guard++) {
+        p.tick(millis());
+        g_micros += 1000;
+        if (guard > 5000) { printf("stuck at page %d\n", pages); return 1; }
+      }
+      g_serial_at = ~0UL;
+    }
+    if (line != lines.size() || pages < 2) { fails++; printf("showed %zu of %zu lines on %d pages\n", line, lines.size(), pages); }
+  }
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
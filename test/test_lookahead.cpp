@@ -0,0 +1,56 @@
+// flags:
+// flags: -DSSD1306FUNC_SCENE_PREFETCH=1
+// Scene prefetch: the blits after a CTC are drawn during the wait, so the confirm shows them after
+// one transfer instead of after decoding. Built both ways, the scene ends on the same screen.
+#include "SSD1306Func.h"
+#include "lookahead.h"
+
+// An image that takes 300us per row to decode
+struct SlowSource : RamImageSource {
+  SlowSource(const uint8_t* bits, int w, int h) : RamImageSource(bits, w, h) {}
+  void read(int16_t row, uint8_t count, int16_t firstbyte, uint8_t bytes, uint8_t* dest) {
+    g_micros += 300 * count;
+    RamImageSource::read(row, count, firstbyte, bytes, dest);
+  }
+};
+
+int main() {
+  Adafruit_SSD1306 a(128, 64, &Wire);
+  a.begin();
+  static uint8_t bits1[1024], bits2[512];
+  for (int i = 0; i < 1024; i++) bits1[i] = i * 7 + 1;
+  for (int i = 0; i < 512; i++) bits2[i] = i * 13 + 5;
+  SlowSource image1(bits1, 128, 64), image2(bits2, 64, 64);
+  ImageSource* images[] = {&image1, &image2};
+
+  g_key_gap = 3000;
+  g_serial_keys = "\n\n\n";
+  g_serial_at = 2000;
+  SceneEffect e;
+  e.begin(&a, lookahead, images, 2);
+  const char* keys = g_serial_keys;
+  unsigned long worst = 0;
+  for (;;) {
+    unsigned long start = millis();
+    bool running = e.tick(millis());
+    // The tick that reads a key runs everything up to the next wait
+    if (g_serial_keys != keys) {
+      keys = g_serial_keys;
+      unsigned long took = millis() - start;
+      printf("confirm to display: %lums\n", took);
+      if (took > worst) worst = took;
+    }
+    if (!running) break;
+    g_micros += 100;
+  }
+
+  uint32_t crc = 0;
+  for (int p = 0; p < 8; p++) for (int c = 0; c < 128; c++) crc = crc * 31 + g_ctl.ram[p][c];
+  for (int i = 0; i < 1024; i++) crc = crc * 31 + a.getBuffer()[i];
+  int bad = crc != 0x245b76bc;
+#if SSD1306FUNC_SCENE_PREFETCH
+  bad += worst > 30;
+#endif
+  printf("crc=%08x worst=%lums bad=%d\n", crc, worst, bad);
+  return bad != 0;
+}
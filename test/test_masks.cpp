@@ -0,0 +1,48 @@
+// The mask fades against the line-drawing versions they replaced, on every rotation and both heights.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+// What the original line-drawing fades drew for one step
+static void drawReference(Adafruit_SSD1306* d, int kind, int steps, int step, uint16_t state) {
+  if (kind == 0) {
+    if (step == 0) for (int i = 0; i < d->width(); i += 2) d->drawFastVLine(i, 0, d->height(), state);
+    else if (step == 1) for (int i = 0; i < d->height(); i += 2) d->drawFastHLine(0, i, d->width(), state);
+    else for (int i = 1; i < d->width(); i += 2) d->drawFastVLine(i, 0, d->height(), state);
+  }
+  if (kind == 1) for (int i = step; i < d->width() + d->height(); i += 2) d->drawLine(0, i, i, 0, state);
+  if (kind == 2) for (int j = step; j < d->width(); j += steps) d->drawFastVLine(j, 0, d->height(), state);
+  if (kind == 3) for (int j = step; j < d->height(); j += steps) d->drawFastHLine(0, j, d->width(), state);
+  if (kind == 4) for (int j = step; j < d->width() + d->height(); j += steps) d->drawLine(0, j, j, 0, state);
+}
+
+int main() {
+  int bad = 0, runs = 0;
+  uint32_t seed = 3;
+  for (int h : {64, 32}) for (int rot = 0; rot < 4; rot++) for (int kind = 0; kind < 5; kind++) for (int cycle : {1, 2, 3, 4, 5, 7, 9, 13}) for (int state = 0; state < 2; state++) {
+    Adafruit_SSD1306 a(128, h, &Wire), b(128, h, &Wire);
+    a.begin(); b.begin();
+    a.setRotation(rot); b.setRotation(rot);
+    for (int i = 0; i < 128 * h / 8; i++) { seed = seed * 1103515245u + 12345u; a.getBuffer()[i] = b.getBuffer()[i] = seed >> 16; }
+
+    FadeGridEffect grid; FadeCrossEffect cross; FadeVerticalEffect vertical; FadeHorizontalEffect horizontal; FadeDiagonalEffect diagonal;
+    SSD1306Effect* effect;
+    int steps;
+    if (kind == 0) { grid.begin(&b, 1000, state); effect = &grid; steps = 3; }
+    else if (kind == 1) { cross.begin(&b, 1000, state); effect = &cross; steps = 2; }
+    else if (kind == 2) { vertical.begin(&b, cycle, 1000L * cycle, state); effect = &vertical; steps = cycle; }
+    else if (kind == 3) { horizontal.begin(&b, cycle, 1000L * cycle, state); effect = &horizontal; steps = cycle; }
+    else { diagonal.begin(&b, cycle, 1000L * cycle, state); effect = &diagonal; steps = cycle; }
+
+    for (int k = 0; k < steps; k++) {
+      drawReference(&a, kind, steps, k, state);
+      effect->tick(millis());
+      g_micros += 1000000ULL;
+      if (memcmp(a.getBuffer(), b.getBuffer(), 128 * h / 8)) {
+        if (++bad < 6) printf("h=%d rot=%d kind=%d cycle=%d state=%d step=%d\n", h, rot, kind, cycle, state, k);
+      }
+    }
+    runs++;
+  }
+  printf("runs=%d bad=%d\n", runs, bad);
+  return bad != 0;
+}
@@ -0,0 +1,39 @@
+// Effects on two displays behind a select hook run together in the time of the slower one.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+static int selects = 0, channel = -1;
+static void selectChannel(uint8_t c) { selects++; channel = c; }
+
+int main() {
+  Adafruit_SSD1306 a(128, 64, &Wire), b(128, 64, &Wire);
+  a.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  b.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  setDisplaySelect(&a, selectChannel, 0);
+  setDisplaySelect(&b, selectChannel, 1);
+
+  g_micros = 0;
+  FadeGridEffect grid;
+  grid.begin(&a, 100, 1);
+  runEffect(grid);
+  unsigned long alonea = millis();
+  g_micros = 0;
+  FadeVerticalEffect vertical;
+  vertical.begin(&b, 8, 400, 1);
+  runEffect(vertical);
+  unsigned long aloneb = millis();
+
+  a.clearDisplay(); b.clearDisplay();
+  g_micros = 0;
+  selects = 0;
+  grid.begin(&a, 100, 1);
+  vertical.begin(&b, 8, 400, 1);
+  SSD1306Effect* effects[] = {&grid, &vertical};
+  runEffects(effects, 2);
+  unsigned long together = millis();
+  printf("a alone %lums, b alone %lums, together %lums, selects=%d last=%d\n", alonea, aloneb, together, selects, channel);
+
+  int fails = together > max(alonea, aloneb) + 10 || !selects || channel != 1;
+  printf("fails=%d\n", fails);
+  return fails;
+}
@@ -0,0 +1,42 @@
+// Dialog reveals keep to their schedule: time spent drawing comes out of the character delay, and
+// the last group gets its delay before the end CTC starts.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+struct Probe : DialogTextEffect {
+  bool isRevealing() { return phase <= DIALOG_TEXT || phase == DIALOG_CTC_PENDING; }
+  bool isEnding() { return phase == DIALOG_END_CTC; }
+};
+
+int main() {
+  Adafruit_SSD1306 d(128, 64, &Wire);
+  d.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  d.setTextColor(SSD1306_WHITE);
+  const char* text = "The quick brown fox jumps over the lazy dog, again and again, until the line wraps many times over.";
+  int fails = 0;
+  for (int speed : {3, 1, 3}) {
+    g_micros = 0;
+    Probe p;
+    p.begin(&d, speed, 10, 0, 0, 0, 0, 1, "H", text);
+    while (p.isRevealing()) { p.tick(millis()); yield(); }
+    unsigned long took = g_micros / 1000, ideal = (strlen(text) + speed - 1) / speed * 10;
+    printf("speed=%d reveal took %lums (ideal %lums)\n", speed, took, ideal);
+    if (took > ideal || took < ideal * 9 / 10) fails++;
+    d.clearDisplay(); d.display();
+  }
+
+  // Texts whose last group is full and partial: the end CTC starts one delay after the last group is drawn
+  for (const char* end : {"abcdef", "abcdefg", "abcdefgh"}) {
+    g_micros = 0;
+    Probe p;
+    p.begin(&d, 3, 10, 0, 0, 0, 0, 1, "H", end);
+    while (!p.isEnding()) { p.tick(millis()); yield(); }
+    unsigned long took = g_micros / 1000, ideal = (strlen(end) + 2) / 3 * 10;
+    printf("\"%s\" end CTC after %lums (ideal %lums)\n", end, took, ideal);
+    if (took < ideal || took > ideal + 5) fails++;
+    p.stop();
+    d.clearDisplay(); d.display();
+  }
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
@@ -0,0 +1,39 @@
+// PageImageSource, in the SSD1306 page layout, reads and blits like the row layout it was converted from.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+int main() {
+  uint32_t seed = 11;
+  int bad = 0;
+  auto rnd = [&]() { seed = seed * 1103515245u + 12345u; return seed >> 8; };
+  static uint8_t rows[200 * 25], pages[25 * 200];
+  for (int t = 0; t < 3000; t++) {
+    int w = 1 + rnd() % 200, h = 1 + rnd() % 200, bytewidth = (w + 7) / 8;
+    for (int i = 0; i < bytewidth * h; i++) rows[i] = rnd();
+    for (int y = 0; y < h; y++) rows[y * bytewidth + bytewidth - 1] &= 0xFF << (bytewidth * 8 - w);
+    memset(pages, 0, sizeof(pages));
+    for (int y = 0; y < h; y++) for (int x = 0; x < w; x++) if (rows[y * bytewidth + x / 8] & (0x80 >> (x & 7))) pages[(y / 8) * w + x] |= 1 << (y & 7);
+    ProgmemImageSource a(rows, w, h);
+    PageImageSource b(pages, w, h);
+
+    uint8_t ra[25], rb[25];
+    int row = rnd() % h, firstbyte = rnd() % bytewidth, bytes = 1 + rnd() % (bytewidth - firstbyte);
+    a.read(row, 1, firstbyte, bytes, ra);
+    b.read(row, 1, firstbyte, bytes, rb);
+    if (memcmp(ra, rb, bytes)) { bad++; printf("read t=%d\n", t); }
+
+    Adafruit_SSD1306 da(128, 64, &Wire), db(128, 64, &Wire);
+    da.begin(); db.begin();
+    for (int i = 0; i < 1024; i++) da.getBuffer()[i] = db.getBuffer()[i] = rnd();
+    int rot = (rnd() % 4) ? 0 : rnd() % 4;
+    da.setRotation(rot); db.setRotation(rot);
+    int x = (int)(rnd() % 260) - 130, y = (int)(rnd() % 200) - 100;
+    if (rnd() % 3 == 0) y &= ~7;
+    uint16_t color = rnd() % 3;
+    blitImage(&da, x, y, a, color);
+    blitImage(&db, x, y, b, color);
+    if (memcmp(da.getBuffer(), db.getBuffer(), 1024)) { if (++bad < 5) printf("blit t=%d %dx%d at %d,%d color=%d rot=%d\n", t, w, h, x, y, color, rot); }
+  }
+  printf("bad=%d\n", bad);
+  return bad != 0;
+}
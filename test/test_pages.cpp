@@ -0,0 +1,73 @@
+// PageFadeEffect, which renders a page at a time without a framebuffer, sends the same bytes as
+// MaskFadeEffect over an equivalent framebuffer.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+struct Screen {
+  int16_t imagex, imagey, textx, texty;
+  uint16_t imagecolor;
+  const char* text;
+  ImageSource* image;
+};
+
+static void render(Adafruit_SSD1306* d, uint8_t page, uint8_t* strip, void* context) {
+  Screen* s = (Screen*)context;
+  blitImageToPage(d, page, strip, s->imagex, s->imagey, *s->image, s->imagecolor);
+  writeTextToPage(d, page, strip, s->textx, s->texty, s->text);
+}
+
+int main() {
+  Adafruit_SSD1306 a(128, 64, &Wire), b(128, 64, &Wire);
+  a.begin(); b.begin();
+  releaseFramebuffer(&b);
+  uint32_t seed = 5;
+  int bad = 0, frames = 0;
+  auto rnd = [&]() { seed = seed * 1103515245u + 12345u; return seed >> 8; };
+  static uint8_t bits[40 * 5];
+  for (int t = 0; t < 600; t++) {
+    for (int i = 0; i < 200; i++) bits[i] = rnd();
+    int w = 1 + rnd() % 40, h = 1 + rnd() % 40;
+    RamImageSource image(bits, w, h);
+    char text[24];
+    int n = 1 + rnd() % 22;
+    for (int i = 0; i < n; i++) text[i] = 32 + rnd() % 90;
+    text[n] = 0;
+    Screen s;
+    s.imagex = (int)(rnd() % 160) - 20;
+    s.imagey = (int)(rnd() % 90) - 20;
+    s.textx = (int)(rnd() % 150) - 10;
+    s.texty = (int)(rnd() % 70) - 3;
+    s.imagecolor = rnd() % 3;
+    s.text = text;
+    s.image = &image;
+    uint16_t color = rnd() % 3, bg = (rnd() % 2) ? color : rnd() % 2;
+    if (bg != color && color > 1) color = 1;
+    for (Adafruit_SSD1306* d : {&a, &b}) { d->setTextWrap(false); d->setTextColor(color, bg); }
+    FadeMask mask = {NULL, (uint16_t)(1 + rnd() % 6), (int8_t)(rnd() % 3 - 1), (int8_t)(rnd() % 3 - 1)};
+    uint16_t state = rnd() % 2;
+
+    a.clearDisplay();
+    blitImage(&a, s.imagex, s.imagey, image, s.imagecolor);
+    a.setCursor(s.textx, s.texty);
+    a.print(text);
+    MaskFadeEffect framebuffered;
+    PageFadeEffect paged;
+    framebuffered.begin(&a, mask, 0, state);
+    paged.begin(&b, render, &s, mask, 0, state);
+    uint8_t ram[8][128];
+    for (;;) {
+      bool runninga = framebuffered.tick(millis());
+      memcpy(ram, g_ctl.ram, sizeof(ram));
+      bool runningb = paged.tick(millis());
+      if (runninga != runningb || memcmp(ram, g_ctl.ram, sizeof(ram))) {
+        if (++bad < 5) printf("t=%d image %d,%d %dx%d text %d,%d color=%d bg=%d mask %d %d %d state=%d\n", t, s.imagex, s.imagey, w, h, s.textx, s.texty,
+                              color, bg, mask.steps, mask.dx, mask.dy, state);
+        break;
+      }
+      frames++;
+      if (!runninga) break;
+    }
+  }
+  printf("frames=%d bad=%d\n", frames, bad);
+  return bad != 0;
+}
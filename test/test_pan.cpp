@@ -0,0 +1,62 @@
+// PanEffect views along random paths against fresh blits, ending exactly on the last point.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+struct Probe : PanEffect {
+  int16_t getX() { return view_x; }
+  int16_t getY() { return view_y; }
+};
+
+struct CountingSource : RamImageSource {
+  CountingSource(const uint8_t* bits, int w, int h) : RamImageSource(bits, w, h) {}
+  void read(int16_t row, uint8_t count, int16_t firstbyte, uint8_t bytes, uint8_t* dest) {
+    readbytes += count * bytes;
+    RamImageSource::read(row, count, firstbyte, bytes, dest);
+  }
+  unsigned long readbytes = 0;
+};
+
+int main() {
+  uint32_t seed = 3;
+  int bad = 0;
+  long frames = 0;
+  unsigned long maxperframe = 0;
+  auto rnd = [&]() { seed = seed * 1103515245u + 12345u; return seed >> 8; };
+  static uint8_t bits[40 * 300];
+  for (int t = 0; t < 200; t++) {
+    int height = (rnd() % 4) ? 64 : 32;
+    Adafruit_SSD1306 a(128, height, &Wire), r(128, height, &Wire);
+    a.begin(); r.begin();
+    for (int i = 0; i < (int)sizeof(bits); i++) bits[i] = rnd();
+    int w = 1 + rnd() % 320, h = 1 + rnd() % 300;
+    CountingSource image(bits, w, h);
+    PanPoint path[5];
+    int n = 1 + rnd() % 5;
+    for (int i = 0; i < n; i++) {
+      path[i].x = (int)(rnd() % (w + 100)) - 50;
+      path[i].y = (int)(rnd() % (h + 60)) - 30;
+      path[i].duration = rnd() % 400;
+    }
+    Probe e;
+    e.begin(&a, 10 + rnd() % 20, rnd() % 4, path, n, image);
+    unsigned long last = 0;
+    while (e.tick(millis())) {
+      r.clearDisplay();
+      blitImage(&r, -e.getX(), -e.getY(), (ImageSource&)image, 1);
+      if (memcmp(r.getBuffer(), a.getBuffer(), 128 * height / 8)) {
+        if (++bad < 4) printf("t=%d height=%d %dx%d view %d,%d\n", t, height, w, h, e.getX(), e.getY());
+        break;
+      }
+      if (frames && image.readbytes - last > maxperframe) maxperframe = image.readbytes - last;
+      last = image.readbytes;
+      frames++;
+      g_micros += 1000;
+    }
+    if (e.getX() != path[n - 1].x || e.getY() != path[n - 1].y) {
+      bad++;
+      printf("t=%d ended at %d,%d instead of %d,%d\n", t, e.getX(), e.getY(), path[n - 1].x, path[n - 1].y);
+    }
+  }
+  printf("frames=%ld max read bytes/frame=%lu bad=%d\n", frames, maxperframe, bad);
+  return bad != 0;
+}
@@ -0,0 +1,54 @@
+// Region fill, invert, save and restore against per-pixel references on every rotation, and
+// region flushes sending only their pages.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+int main() {
+  Adafruit_SSD1306 a(128, 64, &Wire), b(128, 64, &Wire), saved(128, 64, &Wire);
+  a.begin(); b.begin(); saved.begin();
+  uint32_t seed = 7;
+  int bad = 0, runs = 0;
+  auto rnd = [&]() { seed = seed * 1103515245u + 12345u; return seed >> 8; };
+  static uint8_t region[1024];
+  uint8_t* fa = a.getBuffer();
+  uint8_t* fb = b.getBuffer();
+  for (int t = 0; t < 4000; t++) {
+    int rot = rnd() % 4;
+    a.setRotation(rot); b.setRotation(rot); saved.setRotation(rot);
+    for (int i = 0; i < 1024; i++) fa[i] = fb[i] = rnd();
+    int x = (int)(rnd() % 150) - 10, y = (int)(rnd() % 150) - 10, w = rnd() % 140, h = rnd() % 140;
+    int op = rnd() % 4;
+    if (op < 3) {
+      fillRegion(&a, x, y, w, h, op);
+      for (int i = 0; i < w; i++) for (int j = 0; j < h; j++) b.drawPixel(x + i, y + j, op);
+    } else {
+      if (getRegionSize(&a, x, y, w, h) > sizeof(region)) { bad++; continue; }
+      saveRegion(&a, x, y, w, h, region);
+      memcpy(saved.getBuffer(), fa, 1024);
+      for (int i = 0; i < 1024; i++) fa[i] = fb[i] = rnd();
+      restoreRegion(&a, x, y, w, h, region);
+      for (int i = 0; i < w; i++) for (int j = 0; j < h; j++) b.drawPixel(x + i, y + j, saved.getPixel(x + i, y + j));
+    }
+    if (memcmp(fa, fb, 1024)) { if (++bad < 5) printf("t=%d rot=%d op=%d %d,%d %dx%d\n", t, rot, op, x, y, w, h); }
+    runs++;
+  }
+
+  // Clearing the dialog sends its 6 pages once
+  a.setRotation(0);
+  flushScreen(&a);
+  g_micros += 100000;
+  unsigned long databytes = g_ctl.databytes;
+  clearDialogText(&a);
+  databytes = g_ctl.databytes - databytes;
+  if (databytes != 768) { bad++; printf("clearDialogText sent %lu bytes\n", databytes); }
+
+  memset(g_ctl.ram, 0x55, sizeof(g_ctl.ram));
+  memset(fa, 0xAA, 1024);
+  flushRegion(&a, 10, 20, 30, 20);
+  for (int p = 0; p < 8; p++) for (int c = 0; c < 128; c++) {
+    bool inside = p >= 2 && p <= 4 && c >= 10 && c < 40;
+    if (g_ctl.ram[p][c] != (inside ? 0xAA : 0x55)) { bad++; printf("flushRegion sent page %d column %d\n", p, c); p = 8; break; }
+  }
+  printf("runs=%d bad=%d\n", runs, bad);
+  return bad != 0;
+}
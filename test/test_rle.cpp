@@ -0,0 +1,80 @@
+// The raw, RLE and tile formats written by tools/ssd1306img.py decode to the same pixels, read by
+// read() or through blits and effects.
+#include <initializer_list>
+#include "SSD1306Func.h"
+#include "a_raw.h"
+#include "a_rle.h"
+#include "a_tiles.h"
+#include "b_raw.h"
+#include "b_rle.h"
+#include "b_tiles.h"
+#include "c_raw.h"
+#include "c_rle.h"
+#include "c_tiles.h"
+
+struct Formats {
+  const uint8_t *raw, *rle, *tiles;
+  int width, height;
+};
+
+int main() {
+  Formats images[] = {{a_raw, a_rle, a_tiles, 128, 512}, {b_raw, b_rle, b_tiles, 100, 77}, {c_raw, c_rle, c_tiles, 37, 20}};
+  int bad = 0, runs = 0;
+
+  for (Formats& f : images) for (int rot = 0; rot < 4; rot++) for (int x : {-13, -8, 0, 5, 64, 120}) for (int y : {-300, -9, 0, 3, 40}) {
+    Adafruit_SSD1306 a(128, 64, &Wire), b(128, 64, &Wire), c(128, 64, &Wire);
+    a.begin(); b.begin(); c.begin();
+    a.setRotation(rot); b.setRotation(rot); c.setRotation(rot);
+    ProgmemImageSource raw(f.raw, f.width, f.height);
+    RleImageSource rle(f.rle, f.width, f.height);
+    TileImageSource tiles(f.tiles, f.width, f.height);
+    blitImage(&a, x, y, raw, 2);
+    blitImage(&b, x, y, rle, 2);
+    blitImage(&c, x, y, tiles, 2);
+    runs++;
+    if (memcmp(a.getBuffer(), b.getBuffer(), 1024)) { if (++bad < 5) printf("rle blit w=%d rot=%d x=%d y=%d\n", f.width, rot, x, y); }
+    if (memcmp(a.getBuffer(), c.getBuffer(), 1024)) { if (++bad < 5) printf("tile blit w=%d rot=%d x=%d y=%d\n", f.width, rot, x, y); }
+  }
+
+  // Random reads, including ones that start or end inside a band
+  uint32_t seed = 1;
+  for (Formats& f : images) {
+    ProgmemImageSource raw(f.raw, f.width, f.height);
+    RleImageSource rle(f.rle, f.width, f.height);
+    TileImageSource tiles(f.tiles, f.width, f.height);
+    int bytewidth = (f.width + 7) / 8;
+    for (int k = 0; k < 3000; k++) {
+      seed = seed * 1103515245u + 12345u;
+      int row = (seed >> 8) % f.height, count = 1 + (seed >> 20) % 12;
+      if (row + count > f.height) count = f.height - row;
+      int firstbyte = (seed >> 4) % bytewidth, bytes = 1 + (seed >> 12) % (bytewidth - firstbyte);
+      uint8_t A[512], B[512], C[512];
+      raw.read(row, count, firstbyte, bytes, A);
+      rle.read(row, count, firstbyte, bytes, B);
+      tiles.read(row, count, firstbyte, bytes, C);
+      if (memcmp(A, B, count * bytes) || memcmp(A, C, count * bytes)) {
+        if (++bad < 10) printf("read w=%d row=%d count=%d firstbyte=%d bytes=%d\n", f.width, row, count, firstbyte, bytes);
+      }
+    }
+  }
+
+  Adafruit_SSD1306 a(128, 64, &Wire), b(128, 64, &Wire);
+  a.begin(); b.begin();
+  Image image = {a_raw, 128, 512};
+  RleImageSource rle(a_rle, 128, 512);
+  TileImageSource tiles(a_tiles, 128, 512);
+  fadeInGridBitmap(&a, 1, 1, 0, -100, image);
+  fadeInGridBitmap(&b, 1, 1, 0, -100, rle);
+  if (memcmp(a.getBuffer(), b.getBuffer(), 1024)) { bad++; printf("fadeInGridBitmap\n"); }
+  drawVerticalScrollingBitmap(&a, 1, 1, 1, 7, false, false, 0, 0, 300, image);
+  drawVerticalScrollingBitmap(&b, 1, 1, 1, 7, false, false, 0, 0, 300, rle);
+  if (memcmp(a.getBuffer(), b.getBuffer(), 1024)) { bad++; printf("drawVerticalScrollingBitmap\n"); }
+  drawHardwareScrollingBitmap(&a, 1, 1, 1, 3, 0, 400, image);
+  drawHardwareScrollingBitmap(&b, 1, 1, 1, 3, 0, 400, tiles);
+  if (memcmp(a.getBuffer(), b.getBuffer(), 1024)) { bad++; printf("drawHardwareScrollingBitmap tiles\n"); }
+  drawHardwareScrollingBitmap(&b, 1, 1, 1, 3, 0, 400, rle);
+  if (memcmp(a.getBuffer(), b.getBuffer(), 1024)) { bad++; printf("drawHardwareScrollingBitmap rle\n"); }
+
+  printf("runs=%d bad=%d\n", runs, bad);
+  return bad != 0;
+}
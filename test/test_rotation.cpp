@@ -0,0 +1,40 @@
+// Partial flushes on rotated and 32-row panels leave the controller RAM equal to the framebuffer.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+static uint8_t bits[16 * 150];
+
+static int check(Adafruit_SSD1306& d, int h, const char* what, int rot) {
+  int bad = 0;
+  for (int p = 0; p < h / 8; p++) for (int c = 0; c < 128; c++) if (g_ctl.ram[p][c] != d.getBuffer()[p * 128 + c]) bad++;
+  if (bad) printf("%s rot=%d h=%d: %d bytes differ\n", what, rot, h, bad);
+  return bad != 0;
+}
+
+int main() {
+  uint32_t seed = 4;
+  for (uint8_t& b : bits) { seed = seed * 1103515245u + 12345u; b = seed >> 16; }
+  Image tall = {bits, 128, 150}, small = {bits, 37, 29};
+  int fails = 0;
+  g_serial_at = 0;
+  g_key_gap = 1;
+  for (int h : {64, 32}) for (int rot = 0; rot < 4; rot++) {
+    Adafruit_SSD1306 d(128, h, &Wire);
+    d.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+    d.setTextColor(SSD1306_WHITE);
+    d.setRotation(rot);
+    d.clearDisplay(); d.display();
+    fadeVertical(&d, 3, 10, 1); fails += check(d, h, "fadeVertical", rot);
+    fadeDissolve(&d, 1, 0); fails += check(d, h, "fadeDissolve", rot);
+    blitImage(&d, 5, 3, small, 1); markDirty(&d, 5, 3, 37, 29); flushDirty(&d); fails += check(d, h, "blit", rot);
+    blitImage(&d, -9, 11, small, 2); markDirty(&d, -9, 11, 37, 29); flushDirty(&d); fails += check(d, h, "blit inverse", rot);
+    drawDialogText(&d, 2, 1, 1, 1, "Hdr", "Some text that wraps around the rotated screen."); fails += check(d, h, "dialog", rot);
+    clearDialogText(&d); fails += check(d, h, "clearDialogText", rot);
+    d.clearDisplay(); d.display();
+    drawVerticalScrollingBitmap(&d, 1, 1, 1, 5, false, false, 0, 0, 0, tall); fails += check(d, h, "vertical scroll", rot);
+    drawHardwareScrollingBitmap(&d, 1, 1, 1, 5, 0, 0, tall); fails += check(d, h, "hardware scroll", rot);
+    fillScreenSlow(&d); fails += check(d, h, "fillScreenSlow", rot);
+  }
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
@@ -0,0 +1,59 @@
+// A compiled scene, played from PROGMEM and from a reader, draws what the same calls made by hand draw.
+#include <initializer_list>
+#include "SSD1306Func.h"
+#include "scene.h"
+
+static uint8_t bits0[3 * 16], bits1[16 * 96];
+static uint8_t script[512];
+static size_t scriptlength;
+
+// Past the end of the script reads as garbage, like an SD card would
+static void reader(void*, uint32_t offset, uint8_t* dest, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) dest[i] = offset + i < scriptlength ? script[offset + i] : 0xEE;
+}
+
+int main() {
+  for (unsigned i = 0; i < sizeof(bits0); i++) bits0[i] = i * 37 + 5;
+  for (unsigned i = 0; i < sizeof(bits1); i++) bits1[i] = i * 73 + 11;
+  FILE* f = fopen("scene.bin", "rb");
+  if (!f) { printf("no scene.bin\n"); return 1; }
+  scriptlength = fread(script, 1, sizeof(script), f);
+  fclose(f);
+
+  Image image0 = {bits0, 24, 16}, image1 = {bits1, 128, 96};
+  ProgmemImageSource source0(image0), source1(image1);
+  ImageSource* images[] = {&source0, &source1};
+  uint8_t screens[3][1024];
+  int fails = 0;
+  for (int mode = 0; mode < 3; mode++) {
+    Adafruit_SSD1306 d(128, 64, &Wire);
+    d.begin();
+    d.setTextColor(SSD1306_WHITE);
+    g_micros = 0;
+    g_serial_at = 0;
+    g_key_gap = 1500;
+    if (mode == 0) playScene(&d, scene, images, 2);
+    else if (mode == 1) playScene(&d, reader, NULL, images, 2);
+    else {
+      drawTimedDialogText(&d, 2, 10, 100, 700, 1, 1, 1, "Narrator", "Hello there` traveller,\nwelcome.");
+      clearDialogText(&d);
+      clearHeaderText(&d);
+      fadeGrid(&d, 30, 0);
+      fadeVertical(&d, 4, 40, 1);
+      blitImage(&d, 10, 20, image0, 1);
+      fadeInGridBitmap(&d, 20, 100, 32, 8, image0);
+      delay(250);
+      drawVerticalScrollingBitmap(&d, 100, 100, 20, 2, true, false, 0, 0, 0, image1);
+      ctcTimedSerial(&d, 300);
+      drawTimedDialogText(&d, 2, 10, 100, 700, 0, 0, 0, "Narrator", "Done.");
+      ctcTimed(&d, 9, 200);
+    }
+    memcpy(screens[mode], d.getBuffer(), 1024);
+    bool shown = !memcmp(g_ctl.ram, d.getBuffer(), 1024);
+    printf("mode %d took %lums, shown=%d\n", mode, millis(), shown);
+    fails += !shown;
+  }
+  fails += (memcmp(screens[0], screens[1], 1024) != 0) + (memcmp(screens[0], screens[2], 1024) != 0);
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
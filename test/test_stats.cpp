@@ -0,0 +1,32 @@
+// flags: -DSSD1306FUNC_STATS=1
+// Effect statistics count what actually went over the bus.
+#include "SSD1306Func.h"
+
+static int fails = 0;
+
+static void check(const char* name, EffectStats stats, unsigned long wirebytes) {
+  printf("%-18s ", name);
+  printEffectStats(Serial, stats);
+  printf("%-18s ", "");
+  printBusEstimates(Serial, stats);
+  // The library counts command and data bytes; the wire adds an address and control byte per transaction
+  if (!stats.frames || stats.bytes > wirebytes || stats.bytes < wirebytes * 3 / 4) { fails++; printf("  wire bytes %lu\n", wirebytes); }
+}
+
+int main() {
+  Adafruit_SSD1306 d(128, 64, &Wire);
+  d.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  d.setTextColor(SSD1306_WHITE);
+  static uint8_t bits[16 * 200];
+  Image image = {bits, 128, 200};
+  Serial.echo = true;
+
+  Wire.bytes = 0; fadeVertical(&d, 4, 40, 1); check("fadeVertical", getLastEffectStats(), Wire.bytes);
+  Wire.bytes = 0; fadeGrid(&d, -1, 0); check("fadeGrid", getLastEffectStats(), Wire.bytes);
+  Wire.bytes = 0; drawHardwareScrollingBitmap(&d, 0, 0, 1, 2, 0, 0, image); check("hardware scroll", getLastEffectStats(), Wire.bytes);
+  VerticalScrollEffect e;
+  e.begin(&d, 0, 0, 5, 4, false, false, 0, 0, 0, image);
+  Wire.bytes = 0; runEffect(e); check("vertical scroll", e.getStats(), Wire.bytes);
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
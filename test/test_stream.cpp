@@ -0,0 +1,43 @@
+// Streamed bitmaps scroll like in-memory ones, and the software scroller fetches each source row
+// about once instead of the whole visible window per step.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+static uint8_t bits[16 * 3000];
+static unsigned long readbytes = 0, reads = 0;
+
+static void reader(void* context, uint32_t offset, uint8_t* dest, uint16_t count) {
+  memcpy(dest, (uint8_t*)context + offset, count);
+  readbytes += count;
+  reads++;
+}
+
+int main() {
+  uint32_t seed = 9;
+  for (uint8_t& b : bits) { seed = seed * 1103515245u + 12345u; b = seed >> 16; }
+  int fails = 0;
+
+  Adafruit_SSD1306 d(128, 64, &Wire), e(128, 64, &Wire);
+  d.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  e.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  StreamImageSource source(reader, bits, 128, 3000);
+  Image image = {bits, 128, 3000};
+
+  g_micros = 0;
+  drawHardwareScrollingBitmap(&d, 0, 0, 1, 4, 0, 0, source);
+  printf("hardware: read %lu bytes in %lu calls, t=%lums\n", readbytes, reads, (unsigned long)(g_micros / 1000));
+  drawHardwareScrollingBitmap(&e, 0, 0, 1, 4, 0, 0, image);
+  if (memcmp(d.getBuffer(), e.getBuffer(), 1024)) { fails++; printf("hardware scroll differs from Image\n"); }
+
+  readbytes = reads = 0;
+  d.clearDisplay(); e.clearDisplay();
+  g_micros = 0;
+  drawVerticalScrollingBitmap(&d, 0, 0, 1, 8, false, false, 0, 0, 0, source);
+  printf("software: read %lu bytes in %lu calls, t=%lums\n", readbytes, reads, (unsigned long)(g_micros / 1000));
+  drawVerticalScrollingBitmap(&e, 0, 0, 1, 8, false, false, 0, 0, 0, image);
+  if (memcmp(d.getBuffer(), e.getBuffer(), 1024)) { fails++; printf("software scroll differs from Image\n"); }
+  if (readbytes > 16 * (3000 + 64)) { fails++; printf("software scroll reads rows more than once\n"); }
+
+  printf("fails=%d\n", fails);
+  return fails != 0;
+}
@@ -0,0 +1,50 @@
+// writeText against GFX print() for random text, colors, sizes, wrapping and rotation, and
+// glyph fonts drawn through the byte path.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+int main() {
+  Adafruit_SSD1306 a(128, 64, &Wire), b(128, 64, &Wire);
+  a.begin(); b.begin();
+  uint32_t seed = 9;
+  int bad = 0;
+  auto rnd = [&]() { seed = seed * 1103515245u + 12345u; return seed >> 8; };
+  for (int t = 0; t < 4000; t++) {
+    for (int i = 0; i < 1024; i++) a.getBuffer()[i] = b.getBuffer()[i] = rnd();
+    char text[40];
+    int n = 1 + rnd() % 38;
+    for (int i = 0; i < n; i++) { int r = rnd() % 40; text[i] = r == 0 ? '\n' : r == 1 ? '\r' : (char)(1 + rnd() % 255); }
+    text[n] = 0;
+    int x = (int)(rnd() % 150) - 10, y = (rnd() % 3) ? (int)(rnd() % 8) * 8 : (int)(rnd() % 70) - 3;
+    uint16_t colors[] = {0, 1, 2, 0xFFFF};
+    uint16_t color = colors[rnd() % 4], bg = (rnd() % 2) ? color : colors[rnd() % 4];
+    int rot = (rnd() % 4) ? 0 : rnd() % 4, size = (rnd() % 6) ? 1 : 2;
+    bool wrap = rnd() % 4, cp437 = rnd() % 2;
+    for (Adafruit_SSD1306* d : {&a, &b}) {
+      d->setRotation(rot); d->setTextWrap(wrap); d->cp437(cp437); d->setTextColor(color, bg); d->setTextSize(size); d->setCursor(x, y);
+    }
+    a.print(text);
+    writeText(&b, text);
+    if (memcmp(a.getBuffer(), b.getBuffer(), 1024) || a.getCursorX() != b.getCursorX() || a.getCursorY() != b.getCursorY()) {
+      if (++bad < 5) printf("t=%d x=%d y=%d color=%u bg=%u rot=%d wrap=%d\n", t, x, y, color, bg, rot, wrap);
+    }
+  }
+
+  // Glyph font: page-aligned and shifted, with a character outside the font skipped
+  static const uint8_t columns[] PROGMEM = {0x01, 0x03, 0x07, 0x0F, 0xF0, 0x81, 0x7E, 0x55, 0xAA};
+  GlyphFont font = {columns, 'a', 'c', 3, 4};
+  setGlyphFont(&b, &font);
+  b.setRotation(0); b.setTextSize(1); b.setTextColor(1, 0); b.setTextWrap(true);
+  uint8_t* fb = b.getBuffer();
+  memset(fb, 0, 1024);
+  b.setCursor(2, 8);
+  writeText(&b, "abcz");
+  if (fb[128 + 2] != 0x01 || fb[128 + 6] != 0x0F || fb[128 + 5] != 0 || fb[128 + 12] != 0xAA || b.getCursorX() != 14) { bad++; printf("glyph font aligned\n"); }
+  memset(fb, 0, 1024);
+  b.setCursor(2, 11);
+  writeText(&b, "ab");
+  if (fb[128 + 2] != (0x01 << 3) || fb[128 + 5] != 0 || fb[128 + 6] != (0x0F << 3) || fb[256 + 6] != 0) { bad++; printf("glyph font shifted\n"); }
+
+  printf("bad=%d\n", bad);
+  return bad != 0;
+}
@@ -0,0 +1,38 @@
+// The column-shifting vertical scroller against a fresh blit at the position it reports, for
+// random sizes, steps, offsets and end positions.
+#include <initializer_list>
+#include "SSD1306Func.h"
+
+struct Probe : VerticalScrollEffect {
+  int16_t getY() { return drawn_y; }
+};
+
+int main() {
+  uint32_t seed = 77;
+  int bad = 0;
+  auto rnd = [&]() { seed = seed * 1103515245u + 12345u; return seed >> 8; };
+  static uint8_t bits[16 * 200];
+  for (int t = 0; t < 300; t++) {
+    int height = (rnd() % 4) ? 64 : 32;
+    Adafruit_SSD1306 a(128, height, &Wire), r(128, height, &Wire);
+    a.begin(); r.begin();
+    for (int i = 0; i < (int)sizeof(bits); i++) bits[i] = rnd();
+    int w = 1 + rnd() % 128, h = 1 + rnd() % 200;
+    RamImageSource image(bits, w, h);
+    int step = (int)(rnd() % 21) - 10;
+    bool snap = rnd() % 2, overflow = rnd() % 2;
+    int16_t offx = (int)(rnd() % 60) - 20, offy = (int)(rnd() % 80) - 30, endy = (int)(rnd() % 220) - 20;
+    Probe e;
+    e.begin(&a, 0, 0, 0, step, snap, overflow, offx, offy, endy, image);
+    for (int n = 0; e.tick(millis()) && n < 400; n++) {
+      r.clearDisplay();
+      blitImage(&r, offx, e.getY(), image, 1);
+      if (memcmp(r.getBuffer(), a.getBuffer(), 128 * height / 8)) {
+        if (++bad < 4) printf("t=%d n=%d height=%d %dx%d step=%d offx=%d offy=%d y=%d\n", t, n, height, w, h, step, offx, offy, e.getY());
+        break;
+      }
+    }
+  }
+  printf("bad=%d\n", bad);
+  return bad != 0;
+}
@@ -0,0 +1,431 @@
+#!/usr/bin/env python3
+"""Converts images into PROGMEM arrays for SSD1306Func.
+
+    python3 tools/ssd1306img.py logo.png --name logo --format rle > logo.h
+    python3 tools/ssd1306img.py title.png --name title --format pages > title.h
+    python3 tools/ssd1306img.py photo.png --name photo --format gray --bits 2 > photo.h
+    python3 tools/ssd1306img.py walk*.png --name walk --format delta --loop > walk.h
+    python3 tools/ssd1306img.py digits.png --name digits --format font --first 0 --glyph-width 4 > digits.h
+
+Formats:
+  raw    Rows of (width + 7) / 8 bytes, MSB first. Use with `Image` or `ProgmemImageSource`.
+  rle    A little-endian uint16 offset per 8-row band, then each band as PackBits runs over its byte
+         columns, 8 rows per column. Use with `RleImageSource`.
+  tiles  A tile number per 8-row band and byte column, then each distinct 8x8 tile as 8 row bytes.
+         Use with `TileImageSource`. At most 256 distinct tiles.
+  pages  The SSD1306's own layout: (height + 7) / 8 pages of width column bytes, top pixel in bit 0.
+         Use with `PageImageSource`; unrotated draws copy it into the framebuffer without transposing.
+  gray   Rows of (width * bits + 7) / 8 bytes, --bits per pixel MSB first, from 0 (off) to fully on.
+         Use with `GrayImage`, for `drawDitheredImage` and `drawGrayscaleImage`. PGM files are read
+         directly, and --threshold is not used.
+  delta  Takes several frames and writes, for each, the bytes that changed since the previous one, in
+         the SSD1306 page layout: runs of page, column and count, then count bytes to XOR, ended by
+         0xFF. Also writes the `AnimationFrame` array for `playAnimation`. With --loop, a last frame
+         leads back to the first, and the animation repeats from frame 1.
+  font   Takes a strip of glyphs at most 8 pixels high, --glyph-width pixels each, from character
+         --first on, and writes their columns top pixel in bit 0, plus the `GlyphFont` for
+         `setGlyphFont`.
+
+PBM files are read directly; anything else needs Pillow (`pip install pillow`). Pixels darker than
+the threshold are off, unless --invert is given.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+
+def read_pbm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    # Header: magic, width and height, separated by whitespace and comments
+    tokens = []
+    pos = 0
+    while len(tokens) < 3:
+        match = re.compile(rb"\s*(#[^\n]*\n\s*)*(\S+)").match(data, pos)
+        if not match:
+            raise ValueError("truncated PBM header")
+        tokens.append(match.group(2))
+        pos = match.end()
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+
+    # PBM stores 1 for black, i.e. an off pixel
+    if magic == b"P4":
+        stride = (width + 7) // 8
+        body = data[pos + 1:]
+        return width, height, [[not (body[y * stride + x // 8] >> (7 - x % 8)) & 1 for x in range(width)] for y in range(height)]
+    if magic == b"P1":
+        bits = [c == ord("1") for c in data[pos:] if c in b"01"]
+        return width, height, [[not bits[y * width + x] for x in range(width)] for y in range(height)]
+    raise ValueError("not a PBM file")
+
+
+def read_pgm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    tokens = []
+    pos = 0
+    while len(tokens) < 4:
+        match = re.compile(rb"\s*(#[^\n]*\n\s*)*(\S+)").match(data, pos)
+        if not match:
+            raise ValueError("truncated PGM header")
+        tokens.append(match.group(2))
+        pos = match.end()
+    magic, width, height, maxval = tokens[0], int(tokens[1]), int(tokens[2]), int(tokens[3])
+
+    if magic == b"P5" and maxval < 256:
+        values = list(data[pos + 1:pos + 1 + width * height])
+    elif magic == b"P2":
+        values = [int(v) for v in data[pos:].split()[:width * height]]
+    else:
+        raise ValueError("not an 8-bit PGM file")
+    return width, height, [[values[y * width + x] * 255 // maxval for x in range(width)] for y in range(height)]
+
+
+def read_levels(path, invert):
+    """Grey levels from 0 (black) to 255, for the gray format."""
+    extension = os.path.splitext(path)[1].lower()
+    if extension == ".pbm":
+        width, height, pixels = read_pbm(path)
+        levels = [[255 if p else 0 for p in row] for row in pixels]
+    elif extension == ".pgm":
+        width, height, levels = read_pgm(path)
+    else:
+        try:
+            from PIL import Image
+        except ImportError:
+            sys.exit("ssd1306img: reading %s needs Pillow, or convert it to PGM first" % path)
+        image = Image.open(path).convert("L")
+        width, height = image.size
+        levels = [[image.getpixel((x, y)) for x in range(width)] for y in range(height)]
+
+    if invert:
+        levels = [[255 - v for v in row] for row in levels]
+    return width, height, levels
+
+
+def pack_gray(width, height, levels, bits):
+    """The gray layout: one list of (width * bits + 7) / 8 bytes per row, pixels MSB first."""
+    top = (1 << bits) - 1
+    rows = []
+    for y in range(height):
+        row = [0] * ((width * bits + 7) // 8)
+        for x in range(width):
+            value = (levels[y][x] * top + 127) // 255
+            bit = x * bits
+            row[bit // 8] |= value << (8 - bits - bit % 8)
+        rows.append(row)
+    return rows
+
+
+def read_image(path, threshold, invert):
+    if os.path.splitext(path)[1].lower() == ".pbm":
+        width, height, pixels = read_pbm(path)
+    else:
+        try:
+            from PIL import Image
+        except ImportError:
+            sys.exit("ssd1306img: reading %s needs Pillow, or convert it to PBM first" % path)
+        image = Image.open(path).convert("L")
+        width, height = image.size
+        pixels = [[image.getpixel((x, y)) >= threshold for x in range(width)] for y in range(height)]
+
+    if invert:
+        pixels = [[not p for p in row] for row in pixels]
+    return width, height, pixels
+
+
+def pack_rows(width, height, pixels):
+    """The raw layout: one list of (width + 7) / 8 bytes per row, padded with off pixels."""
+    rows = []
+    for y in range(height):
+        row = []
+        for b in range((width + 7) // 8):
+            byte = 0
+            for i in range(8):
+                x = b * 8 + i
+                if x < width and pixels[y][x]:
+                    byte |= 0x80 >> i
+            row.append(byte)
+        rows.append(row)
+    return rows
+
+
+def packbits(data):
+    out = []
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 129 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            out += [run + 0x7E, data[i]]
+            i += run
+            continue
+
+        # Literals up to the next run of two or more
+        start = i
+        while i < len(data) and i - start < 128 and not (i + 1 < len(data) and data[i + 1] == data[i]):
+            i += 1
+        if i == start:
+            i += 1
+        out += [i - start - 1] + data[start:i]
+    return out
+
+
+def band_columns(rows, band):
+    """The bytes of one 8-row band, byte column by byte column, with missing rows as off pixels."""
+    bytewidth = len(rows[0]) if rows else 0
+    lines = rows[band * 8:band * 8 + 8]
+    lines += [[0] * bytewidth] * (8 - len(lines))
+    return [lines[i][b] for b in range(bytewidth) for i in range(8)]
+
+
+def encode_rle(rows):
+    bands = (len(rows) + 7) // 8
+    runs = []
+    offsets = []
+    for band in range(bands):
+        offsets.append(len(runs))
+        runs += packbits(band_columns(rows, band))
+    if runs and offsets[-1] > 0xFFFF:
+        sys.exit("ssd1306img: image too large for 16-bit band offsets")
+    return [byte for offset in offsets for byte in (offset & 0xFF, offset >> 8)] + runs
+
+
+def decode_rle(data, bytewidth, height):
+    bands = (height + 7) // 8
+    rows = []
+    for band in range(bands):
+        pos = bands * 2 + data[band * 2] + (data[band * 2 + 1] << 8)
+        out = []
+        while len(out) < bytewidth * 8:
+            control = data[pos]
+            if control & 0x80:
+                out += [data[pos + 1]] * (control - 0x7E)
+                pos += 2
+            else:
+                out += data[pos + 1:pos + 2 + control]
+                pos += control + 2
+        rows += [[out[b * 8 + i] for b in range(bytewidth)] for i in range(min(8, height - band * 8))]
+    return rows
+
+
+def encode_tiles(rows):
+    bytewidth = len(rows[0]) if rows else 0
+    bands = (len(rows) + 7) // 8
+    padded = rows + [[0] * bytewidth] * (bands * 8 - len(rows))
+
+    tiles = []
+    index = {}
+    cells = []
+    for band in range(bands):
+        for b in range(bytewidth):
+            tile = tuple(padded[band * 8 + i][b] for i in range(8))
+            if tile not in index:
+                index[tile] = len(tiles)
+                tiles.append(tile)
+            cells.append(index[tile])
+    if len(tiles) > 256:
+        sys.exit("ssd1306img: %d distinct tiles, more than 256; use --format rle instead" % len(tiles))
+    return cells + [byte for tile in tiles for byte in tile], len(tiles)
+
+
+def decode_tiles(data, bytewidth, height):
+    cells = ((height + 7) // 8) * bytewidth
+    return [[data[cells + data[(y // 8) * bytewidth + b] * 8 + y % 8] for b in range(bytewidth)] for y in range(height)]
+
+
+def page_bytes(width, height, pixels):
+    """The SSD1306 layout: one list of width bytes per 8-row page, top pixel in bit 0."""
+    pages = []
+    for page in range((height + 7) // 8):
+        row = []
+        for x in range(width):
+            byte = 0
+            for i in range(8):
+                y = page * 8 + i
+                if y < height and pixels[y][x]:
+                    byte |= 1 << i
+            row.append(byte)
+        pages.append(row)
+    return pages
+
+
+def encode_delta(before, after):
+    """XOR runs turning the pages `before` into `after`. Gaps of up to 3 unchanged bytes, the cost of a run header, are
+    sent inside a run rather than splitting it."""
+    out = []
+    for page, (old, new) in enumerate(zip(before, after)):
+        diff = [a ^ b for a, b in zip(old, new)]
+        x = 0
+        while x < len(diff):
+            if not diff[x]:
+                x += 1
+                continue
+            start = end = x
+            while x < len(diff) and x - end <= 4 and x - start < 255:
+                if diff[x]:
+                    end = x
+                x += 1
+            out += [page, start, end - start + 1] + diff[start:end + 1]
+            x = end + 1
+    return out + [0xFF]
+
+
+def apply_delta(pages, delta):
+    pages = [list(page) for page in pages]
+    pos = 0
+    while delta[pos] != 0xFF:
+        page, col, count = delta[pos:pos + 3]
+        for i in range(count):
+            pages[page][col + i] ^= delta[pos + 3 + i]
+        pos += 3 + count
+    return pages
+
+
+def format_array(name, data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join("0x%02x" % byte for byte in data[i:i + 16]) + ",")
+    return "const uint8_t %s[] PROGMEM = {\n%s\n};\n" % (name, "\n".join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert an image into a PROGMEM array for SSD1306Func.")
+    parser.add_argument("image", nargs="+", help="input image; PBM, or anything Pillow can open. Several for --format delta")
+    parser.add_argument("--name", help="C identifier of the array (default: from the file name)")
+    parser.add_argument("--format", choices=("raw", "rle", "tiles", "pages", "gray", "delta", "font"), default="raw")
+    parser.add_argument("--threshold", type=int, default=128, help="grey level from which a pixel is on (default: 128)")
+    parser.add_argument("--invert", action="store_true", help="swap on and off pixels")
+    parser.add_argument("--bits", type=int, choices=(2, 4), default=2, help="gray only: bits per pixel (default: 2)")
+    parser.add_argument("--duration", type=int, default=100, help="delta only: milliseconds per frame (default: 100)")
+    parser.add_argument("--loop", action="store_true", help="delta only: add a frame leading back to the first")
+    parser.add_argument("--first", default=" ", help="font only: the first character of the strip, or its code like 0x20 (default: space)")
+    parser.add_argument("--glyph-width", type=int, default=5, help="font only: pixels per glyph in the strip (default: 5)")
+    parser.add_argument("--spacing", type=int, default=1, help="font only: blank columns after each glyph (default: 1)")
+    parser.add_argument("-o", "--output", help="write to this file instead of standard output")
+    args = parser.parse_args()
+
+    name = args.name or re.sub(r"\W", "_", os.path.splitext(os.path.basename(args.image[0]))[0])
+    if args.format == "delta":
+        text, size, raw = convert_delta(args, name)
+    elif args.format == "font":
+        if len(args.image) > 1:
+            parser.error("--format font takes one strip of glyphs")
+        text, size, raw = convert_font(args, name)
+    elif args.format == "gray":
+        if len(args.image) > 1:
+            parser.error("only --format delta takes several images")
+        text, size, raw = convert_gray(args, name)
+    else:
+        if len(args.image) > 1:
+            parser.error("only --format delta takes several images")
+        text, size, raw = convert_image(args, name)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    sys.stderr.write("%s: %d bytes, %.1f%% of raw\n" % (name, size, 100.0 * size / raw if raw else 0))
+
+
+def convert_image(args, name):
+    width, height, pixels = read_image(args.image[0], args.threshold, args.invert)
+    rows = pack_rows(width, height, pixels)
+    bytewidth = (width + 7) // 8
+
+    if args.format == "raw":
+        data = [byte for row in rows for byte in row]
+        usage = "Image %s_image = {%s, %d, %d};" % (name, name, width, height)
+        note = ""
+    elif args.format == "rle":
+        data = encode_rle(rows)
+        assert decode_rle(data, bytewidth, height) == rows
+        usage = "RleImageSource %s_image(%s, %d, %d);" % (name, name, width, height)
+        note = ""
+    elif args.format == "pages":
+        data = [byte for page in page_bytes(width, height, pixels) for byte in page]
+        usage = "PageImageSource %s_image(%s, %d, %d);" % (name, name, width, height)
+        note = ""
+    else:
+        data, count = encode_tiles(rows)
+        assert decode_tiles(data, bytewidth, height) == rows
+        usage = "TileImageSource %s_image(%s, %d, %d);" % (name, name, width, height)
+        note = ", %d distinct tiles" % count
+
+    raw = bytewidth * height
+    header = "// %s: %dx%d, %s, %d bytes (raw: %d)%s\n// %s\n" % (os.path.basename(args.image[0]), width, height, args.format, len(data), raw, note, usage)
+    return header + format_array(name, data), len(data), raw
+
+
+def convert_gray(args, name):
+    width, height, levels = read_levels(args.image[0], args.invert)
+    data = [byte for row in pack_gray(width, height, levels, args.bits) for byte in row]
+    raw = ((width + 7) // 8) * height
+    usage = "GrayImage %s_image = {%s, %d, %d, %d};" % (name, name, width, height, args.bits)
+    header = "// %s: %dx%d, gray, %d bits per pixel, %d bytes (1-bit raw: %d)\n// %s\n" % (os.path.basename(args.image[0]), width, height, args.bits, len(data), raw, usage)
+    return header + format_array(name, data), len(data), raw
+
+
+def convert_delta(args, name):
+    frames = []
+    for path in args.image:
+        width, height, pixels = read_image(path, args.threshold, args.invert)
+        if frames and (width, height) != size:
+            sys.exit("ssd1306img: %s is %dx%d, the first frame is %dx%d" % (path, width, height, size[0], size[1]))
+        if width > 255:
+            sys.exit("ssd1306img: delta frames are at most 255 pixels wide")
+        size = (width, height)
+        frames.append(page_bytes(width, height, pixels))
+
+    # The first frame is drawn over a blank screen
+    blank = [[0] * size[0] for _ in frames[0]]
+    targets = frames + ([frames[0]] if args.loop else [])
+    deltas = []
+    screen = blank
+    for target in targets:
+        deltas.append(encode_delta(screen, target))
+        screen = apply_delta(screen, deltas[-1])
+        assert screen == target
+
+    total = sum(len(delta) for delta in deltas)
+    raw = len(frames) * len(frames[0]) * size[0]
+    if args.loop:
+        usage = "playAnimation(&display, %s, %d, -1, 1);   // forever" % (name, len(deltas))
+    else:
+        usage = "playAnimation(&display, %s, %d, 0, 0);" % (name, len(deltas))
+
+    text = "// %d frames of %dx%d, delta, %d bytes (raw: %d)\n// %s\n" % (len(frames), size[0], size[1], total, raw, usage)
+    for i, delta in enumerate(deltas):
+        text += format_array("%s_%d" % (name, i), delta)
+    text += "const AnimationFrame %s[] = {\n%s\n};\n" % (name, "\n".join("  {%s_%d, %d}," % (name, i, args.duration) for i in range(len(deltas))))
+    return text, total, raw
+
+
+
+def convert_font(args, name):
+    width, height, pixels = read_image(args.image[0], args.threshold, args.invert)
+    if height > 8:
+        sys.exit("ssd1306img: font strips are at most 8 pixels high, %s is %d" % (args.image[0], height))
+    if args.glyph_width < 1 or width % args.glyph_width:
+        sys.exit("ssd1306img: %s is %d pixels wide, not a multiple of --glyph-width %d" % (args.image[0], width, args.glyph_width))
+
+    first = ord(args.first) if len(args.first) == 1 else int(args.first, 0)
+    count = width // args.glyph_width
+    if first + count > 256:
+        sys.exit("ssd1306img: %d glyphs from character %d go past 255" % (count, first))
+
+    data = page_bytes(width, height, pixels)[0]
+    raw = ((width + 7) // 8) * height
+    usage = "GlyphFont %s_font = {%s, %d, %d, %d, %d};" % (name, name, first, first + count - 1, args.glyph_width, args.glyph_width + args.spacing)
+    header = "// %s: %d glyphs of %dx%d, font, %d bytes\n// %s\n" % (os.path.basename(args.image[0]), count, args.glyph_width, height, len(data), usage)
+    return header + format_array(name, data), len(data), raw
+
+
+if __name__ == "__main__":
+    main()
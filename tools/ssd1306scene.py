@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+"""Compiles scene scripts for SSD1306Func's `playScene` into a PROGMEM array, or a binary file for an SD card.
+
+    python3 tools/ssd1306scene.py intro.txt --name intro > intro.h
+    python3 tools/ssd1306scene.py intro.txt --binary -o INTRO.SCN
+
+A script has one command per line; `#` starts a comment. Strings are in double quotes, with C escapes like
+\\n, and " ` " marks a CTC point in a dialog as usual.
+
+  header "Name"                           Header label of the dialogs that follow.
+  speed TEXTSPEED CHARDELAY HEADERDELAY TIMER
+                                          How the dialogs that follow are revealed (default: 1 10 200 10000).
+  dialog [instant] [timed] [timedend] "Text"
+                                          A dialog, revealed one by one unless instant. timed and timedend
+                                          let the timer continue midway and at the end CTCs.
+  clear header|dialog|screen ...          Clears parts of the screen.
+  ctc [serial|PIN] [TIMER]                Waits for a confirm, or at most TIMER ms.
+  fade grid|cross|dissolve [DELAY] in|out
+  fade vertical|horizontal|diagonal [CYCLES [WHOLEDELAY]] in|out
+                                          The fade functions, with their recommended values when left out.
+  image N X Y [DELAY [INITDELAY]]         fadeInGridBitmap of images[N].
+  cross N M X Y KIND [TIMING]             crossFadeImages from images[N] to images[M], with the mask and timing of
+                                          a fade of that kind.
+  blit N X Y [on|off|inverse]             Draws images[N] at once.
+  scroll N INITIALDELAY ENDDELAY SCROLLDELAY STEP X Y END_Y [snap] [overflow]
+                                          drawVerticalScrollingBitmap of images[N].
+  wait MS                                 Waits.
+  label NAME / jump NAME                  Marks a place in the script, and carries on from it.
+  choice [serial|PIN NEXTPIN] "Option" NAME ...
+                                          A choice menu in the dialog area, which carries on from the label
+                                          of the chosen option.
+  end                                     Ends the scene; implied at the end of the file.
+"""
+
+import argparse
+import ast
+import os
+import re
+import shlex
+import sys
+
+# Opcodes and flags, as in SSD1306Func.h
+SCENE_END, SCENE_HEADER, SCENE_SPEED, SCENE_DIALOG, SCENE_CLEAR, SCENE_CTC = range(6)
+SCENE_FADE, SCENE_IMAGE, SCENE_BLIT, SCENE_SCROLL, SCENE_WAIT, SCENE_JUMP = range(6, 12)
+SCENE_CHOICE, SCENE_CROSS = 12, 13
+
+SCENE_ONE_BY_ONE = 0x01
+DIALOG_FLAGS = {"instant": 0, "timed": 0x02, "timedend": 0x04}
+CLEAR_FLAGS = {"header": 0x01, "dialog": 0x02, "screen": 0x04}
+SCROLL_FLAGS = {"snap": 0x01, "overflow": 0x02}
+COLORS = {"off": 0, "on": 1, "inverse": 2}
+CTC_SERIAL = 0xFF
+
+# Per fade: its kind, and the recommended values of the matching fade function. That is steps and step delay for the fades with
+# a fixed number of steps, and cycles and delay per cycle for the others.
+FADES = {
+    "grid": (0, 3, 50, None),
+    "cross": (1, 2, 50, None),
+    "vertical": (2, 4, None, 10),
+    "horizontal": (3, 3, None, 10),
+    "diagonal": (4, 4, None, 25),
+    "dissolve": (5, 8, 40, None),
+}
+FIXED_STEPS = ("grid", "cross", "dissolve")
+
+
+class ScriptError(Exception):
+    pass
+
+
+def u8(value):
+    if not 0 <= value <= 0xFF:
+        raise ScriptError("%d does not fit in a byte" % value)
+    return [value]
+
+
+def s8(value):
+    if not -0x80 <= value <= 0x7F:
+        raise ScriptError("%d does not fit in a signed byte" % value)
+    return [value & 0xFF]
+
+
+def u16(value):
+    if not 0 <= value <= 0xFFFF:
+        raise ScriptError("%d does not fit in 16 bits" % value)
+    return [value & 0xFF, value >> 8]
+
+
+def s16(value):
+    if not -0x8000 <= value <= 0x7FFF:
+        raise ScriptError("%d does not fit in a signed 16-bit value" % value)
+    return u16(value & 0xFFFF)
+
+
+def string(text):
+    data = text.encode("latin-1")
+    if b"\0" in data:
+        raise ScriptError("strings cannot hold a NUL character")
+    return list(data) + [0]
+
+
+def number(word):
+    try:
+        return int(word, 0)
+    except ValueError:
+        raise ScriptError("expected a number, not %r" % word)
+
+
+def flags(words, table):
+    value = 0
+    for word in words:
+        if word not in table:
+            raise ScriptError("unknown flag %r, expected one of %s" % (word, ", ".join(sorted(table))))
+        value |= table[word]
+    return value
+
+
+def unquote(word):
+    # shlex keeps backslashes inside double quotes as they are; read them as C escapes
+    return ast.literal_eval('"%s"' % word.replace('"', '\\"'))
+
+
+def fade_timing(kind, words):
+    """Steps and step delay of a fade of `kind`, from the timing words given after it."""
+    _, steps, stepdelay, cycledelay = FADES[kind]
+    given = [number(w) for w in words]
+    if kind in FIXED_STEPS:
+        if given:
+            stepdelay = given[0]
+    else:
+        if given:
+            steps = given[0]
+        wholedelay = given[1] if len(given) > 1 else cycledelay * steps
+        stepdelay = wholedelay // steps if steps else 0
+    return steps, stepdelay
+
+
+def compile_command(words, labels, fixups, out):
+    command, args = words[0], words[1:]
+    numbers = [w for w in args if re.match(r"^-?(0x[0-9a-fA-F]+|\d+)$", w)]
+    words_only = [w for w in args if w not in numbers]
+
+    if command == "header":
+        return [SCENE_HEADER] + string(unquote(args[0]))
+    if command == "speed":
+        if len(numbers) != 4:
+            raise ScriptError("speed takes TEXTSPEED CHARDELAY HEADERDELAY TIMER")
+        return [SCENE_SPEED] + u8(number(numbers[0])) + u16(number(numbers[1])) + u16(number(numbers[2])) + u16(number(numbers[3]))
+    if command == "dialog":
+        options = args[:-1]
+        value = flags(options, DIALOG_FLAGS)
+        if "instant" not in options:
+            value |= SCENE_ONE_BY_ONE
+        return [SCENE_DIALOG, value] + string(unquote(args[-1]))
+    if command == "clear":
+        return [SCENE_CLEAR, flags(args, CLEAR_FLAGS)]
+    if command == "ctc":
+        button = CTC_SERIAL
+        timer = 0
+        if args and args[0] != "serial":
+            button = number(args[0])
+        if len(args) > 1:
+            timer = number(args[1])
+        return [SCENE_CTC] + u8(button) + u16(timer)
+    if command == "fade":
+        if not args or args[0] not in FADES or args[-1] not in ("in", "out"):
+            raise ScriptError("fade takes a kind (%s), its timing and in or out" % ", ".join(sorted(FADES)))
+        steps, stepdelay = fade_timing(args[0], args[1:-1])
+        return [SCENE_FADE] + u8(FADES[args[0]][0]) + u8(steps) + u16(stepdelay) + [1 if args[-1] == "in" else 0]
+    if command == "cross":
+        if len(args) < 5 or args[4] not in FADES:
+            raise ScriptError("cross takes N M X Y, a kind (%s) and its timing" % ", ".join(sorted(FADES)))
+        steps, stepdelay = fade_timing(args[4], args[5:])
+        return ([SCENE_CROSS] + u8(number(args[0])) + u8(number(args[1])) + s16(number(args[2])) + s16(number(args[3]))
+                + u8(FADES[args[4]][0]) + u8(steps) + u16(stepdelay))
+    if command == "image":
+        values = [number(w) for w in args] + [50, 500][len(args) - 3:]
+        if len(values) != 5:
+            raise ScriptError("image takes N X Y [DELAY [INITDELAY]]")
+        return [SCENE_IMAGE] + u8(values[0]) + s16(values[1]) + s16(values[2]) + u16(values[3]) + u16(values[4])
+    if command == "blit":
+        if len(numbers) != 3:
+            raise ScriptError("blit takes N X Y [on|off|inverse]")
+        color = COLORS[words_only[0]] if words_only else 1
+        return [SCENE_BLIT] + u8(number(numbers[0])) + s16(number(numbers[1])) + s16(number(numbers[2])) + [color]
+    if command == "scroll":
+        if len(numbers) != 8:
+            raise ScriptError("scroll takes N INITIALDELAY ENDDELAY SCROLLDELAY STEP X Y END_Y [snap] [overflow]")
+        n = [number(w) for w in numbers]
+        return [SCENE_SCROLL] + u8(n[0]) + u16(n[1]) + u16(n[2]) + u16(n[3]) + s8(n[4]) + [flags(words_only, SCROLL_FLAGS)] + s16(n[5]) + s16(n[6]) + s16(n[7])
+    if command == "wait":
+        return [SCENE_WAIT] + u16(number(args[0]))
+    if command == "label":
+        if args[0] in labels:
+            raise ScriptError("label %r is defined twice" % args[0])
+        labels[args[0]] = len(out)
+        return []
+    if command == "jump":
+        fixups.append((len(out) + 1, args[0]))
+        return [SCENE_JUMP, 0, 0]
+    if command == "choice":
+        button, nextbutton = CTC_SERIAL, CTC_SERIAL
+        if args and args[0] == "serial":
+            args = args[1:]
+        elif len(args) > 1 and args[0] in numbers and args[1] in numbers:
+            button, nextbutton = number(args[0]), number(args[1])
+            args = args[2:]
+        if not args or len(args) % 2:
+            raise ScriptError("choice takes [serial|PIN NEXTPIN] and pairs of an option and a label")
+        data = [SCENE_CHOICE] + u8(button) + u8(nextbutton) + u8(len(args) // 2)
+        for text, label in zip(args[0::2], args[1::2]):
+            data += string(unquote(text))
+            fixups.append((len(out) + len(data), label))
+            data += [0, 0]
+        return data
+    if command == "end":
+        return [SCENE_END]
+    raise ScriptError("unknown command %r" % command)
+
+
+def compile_script(path):
+    with open(path) as f:
+        lines = f.read().splitlines()
+
+    out = []
+    labels = {}
+    fixups = []
+    last = None
+    for lineno, line in enumerate(lines, 1):
+        try:
+            lexer = shlex.shlex(line, posix=False)
+            lexer.whitespace_split = True
+            lexer.commenters = "#"
+            words = [w[1:-1] if w.startswith('"') and w.endswith('"') else w for w in lexer]
+            if words:
+                out += compile_command(words, labels, fixups, out)
+                last = words[0]
+        except (ScriptError, IndexError, KeyError, ValueError, SyntaxError) as e:
+            sys.exit("%s:%d: %s" % (path, lineno, e if str(e) else "missing arguments"))
+
+    if last != "end":
+        out.append(SCENE_END)
+    for offset, label in fixups:
+        if label not in labels:
+            sys.exit("%s: jump to undefined label %r" % (path, label))
+        out[offset:offset + 2] = u16(labels[label])
+    return out
+
+
+def format_array(name, data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join("0x%02x" % byte for byte in data[i:i + 16]) + ",")
+    return "const uint8_t %s[] PROGMEM = {\n%s\n};\n" % (name, "\n".join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile a scene script for SSD1306Func's playScene.")
+    parser.add_argument("script", help="the scene script")
+    parser.add_argument("--name", help="C identifier of the array (default: from the file name)")
+    parser.add_argument("--binary", action="store_true", help="write the raw bytes, e.g. for an SD card, instead of a C array")
+    parser.add_argument("-o", "--output", help="write to this file instead of standard output")
+    args = parser.parse_args()
+
+    data = compile_script(args.script)
+    name = args.name or re.sub(r"\W", "_", os.path.splitext(os.path.basename(args.script))[0])
+
+    if args.binary:
+        if args.output:
+            with open(args.output, "wb") as f:
+                f.write(bytes(data))
+        else:
+            sys.stdout.buffer.write(bytes(data))
+    else:
+        text = "// %s: %d bytes\n// playScene(&display, %s, images, imagecount);\n" % (os.path.basename(args.script), len(data), name)
+        text += format_array(name, data)
+        if args.output:
+            with open(args.output, "w") as f:
+                f.write(text)
+        else:
+            sys.stdout.write(text)
+    sys.stderr.write("%s: %d bytes\n" % (name, len(data)))
+
+
+if __name__ == "__main__":
+    main()